@@ -0,0 +1,165 @@
+/**
+ * @file ga_renderer_bench.c
+ * @brief Micro-benchmark of the renderer's circle path (`cmake --build . --target bench`).
+ * @details
+ * Times ga_sdl_fitness_callback() on chromosomes of random circles against a random
+ * 640x480 reference, with the kernels ga_kernels_select() picks for the running CPU:
+ *   - full evaluation at level 0, radii <= 50 and radii <= 8;
+ *   - level 0 scoring 1 row in 4 (sample_shift 2);
+ *   - pyramid level 3 scoring 1 row in 4.
+ *
+ * The bench target builds this driver twice: ga_bench with the circle span table, and
+ * ga_bench_sqrtf with CIRCLE_LUT_MAX_RADIUS=0, where every circle row calls sqrtf().
+ * Both print the sum of the fitness values they computed, which must match.
+ *
+ * @path bench/ga_renderer_bench.c
+ */
+
+#include "../includes/software_rendering/ga_renderer.h"
+#include "../includes/software_rendering/ga_kernels.h"
+#include "../includes/genetic_algorithm/genetic_structs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_W        640
+#define BENCH_H        480
+#define BENCH_SHAPES   100
+#define BENCH_CHROMS   32
+#define BENCH_ROUNDS   50
+
+/** @brief Small xorshift generator: the bench only needs repeatable inputs. */
+static Uint32 bench_rand(Uint32 *s)
+{
+    *s ^= *s << 13;
+    *s ^= *s >> 17;
+    *s ^= *s << 5;
+    return *s;
+}
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1.0e6 + (double)ts.tv_nsec / 1.0e3;
+}
+
+/**
+ * @brief Fills @p c with random circles of radius 1..@p max_radius.
+ */
+static void random_circles(Chromosome *c, int max_radius, Uint32 *seed)
+{
+    for (size_t i = 0; i < c->n_shapes; i++) {
+        Gene g;
+        memset(&g, 0, sizeof(g));
+        g.geom.circle.tag    = GENE_CIRCLE_TAG;
+        g.geom.circle.cx     = (int16_t)(bench_rand(seed) % BENCH_W);
+        g.geom.circle.cy     = (int16_t)(bench_rand(seed) % BENCH_H);
+        g.geom.circle.radius = (int16_t)(bench_rand(seed) % (Uint32)max_radius + 1);
+        g.r = (unsigned char)bench_rand(seed);
+        g.g = (unsigned char)bench_rand(seed);
+        g.b = (unsigned char)bench_rand(seed);
+        g.a = (unsigned char)bench_rand(seed);
+        c->shapes[i] = g;
+    }
+    c->parent = NULL;
+}
+
+/**
+ * @brief Times BENCH_ROUNDS evaluations of every chromosome and prints one result line.
+ */
+static void run_case(const char *name, GAFitnessParams *p, const GAEvalContext *ectx,
+                     Chromosome **cs, int max_radius)
+{
+    Uint32 seed = 0x12345678u;
+    for (int i = 0; i < BENCH_CHROMS; i++)
+        random_circles(cs[i], max_radius, &seed);
+
+    double sum = 0.0;
+    for (int i = 0; i < BENCH_CHROMS; i++)   /* Warm-up (and span table creation). */
+        sum += ga_sdl_fitness_callback(cs[i], p, ectx);
+
+    sum = 0.0;
+    double t0 = now_us();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int i = 0; i < BENCH_CHROMS; i++)
+            sum += ga_sdl_fitness_callback(cs[i], p, ectx);
+    }
+    double us = (now_us() - t0) / (double)(BENCH_ROUNDS * BENCH_CHROMS);
+    printf("%-32s %9.1f us/eval   fitness sum %.6f\n", name, us, sum);
+}
+
+int main(void)
+{
+    SysCapabilities caps;
+    memset(&caps, 0, sizeof(caps));
+    pthread_mutex_init(&caps.mutex, NULL);
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    caps.sse4     = __builtin_cpu_supports("sse4.1");
+    caps.avx2     = __builtin_cpu_supports("avx2");
+    caps.avx512   = __builtin_cpu_supports("avx512f");
+    caps.avx512bw = __builtin_cpu_supports("avx512bw");
+#endif
+    ga_kernels_select(&caps);
+    pthread_mutex_destroy(&caps.mutex);
+
+    SDL_PixelFormat *fmt = SDL_AllocFormat(SDL_PIXELFORMAT_ARGB8888);
+    Uint32 *ref = (Uint32 *)malloc((size_t)BENCH_W * BENCH_H * sizeof(Uint32));
+    Chromosome *cs[BENCH_CHROMS];
+    if (!fmt || !ref) {
+        fprintf(stderr, "bench: setup failed\n");
+        return EXIT_FAILURE;
+    }
+    Uint32 seed = 0xC0FFEEu;
+    for (int i = 0; i < BENCH_W * BENCH_H; i++)
+        ref[i] = 0xFF000000u | (bench_rand(&seed) & 0x00FFFFFFu);
+    for (int i = 0; i < BENCH_CHROMS; i++) {
+        cs[i] = chromosome_create(BENCH_SHAPES);
+        if (!cs[i]) {
+            fprintf(stderr, "bench: out of memory\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    GAImagePyramid pyramid = {0};
+    if (ga_pyramid_build(&pyramid, ref, BENCH_W, BENCH_H, 4) != 0) {
+        fprintf(stderr, "bench: pyramid build failed\n");
+        return EXIT_FAILURE;
+    }
+
+    GAFitnessParams p;
+    memset(&p, 0, sizeof(p));
+    p.ref_pixels = ref;
+    p.fmt        = fmt;
+    p.pitch      = BENCH_W * (int)sizeof(Uint32);
+    p.width      = BENCH_W;
+    p.height     = BENCH_H;
+
+    GAEvalContext ectx = { 0, 1, NULL, ga_fitness_scratch_size(&p) };
+    ectx.scratch = aligned_alloc(GA_CACHE_LINE, ectx.scratch_size);
+    if (!ectx.scratch) {
+        fprintf(stderr, "bench: out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("kernels: blend=%s, mse=%s; %d circles, %dx%d\n",
+           ga_kernels()->blend_span_name, ga_kernels()->sse_span_name,
+           BENCH_SHAPES, BENCH_W, BENCH_H);
+    run_case("level 0, r <= 50", &p, &ectx, cs, 50);
+    run_case("level 0, r <= 8", &p, &ectx, cs, 8);
+    p.sample_shift = 2;
+    run_case("level 0, 1/4 rows, r <= 50", &p, &ectx, cs, 50);
+    p.pyramid = &pyramid;
+    p.level   = 3;
+    run_case("level 3, 1/4 rows, r <= 50", &p, &ectx, cs, 50);
+
+    for (int i = 0; i < BENCH_CHROMS; i++)
+        chromosome_destroy(cs[i]);
+    free(ectx.scratch);
+    ga_pyramid_free(&pyramid);
+    free(ref);
+    SDL_FreeFormat(fmt);
+    return EXIT_SUCCESS;
+}
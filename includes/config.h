@@ -6,5 +6,9 @@
 #define HEIGHT    800
 #define IMAGE_W   640
 #define IMAGE_H   480
+#define PYRAMID_LEVELS 4
+#define COLOR_SOLVE_MAX_GENES 4
+#define FITNESS_CACHE_SLOTS 65536
+#define ASYNC_ISLANDS 0
 
 #endif
@@ -0,0 +1,63 @@
+#ifndef GA_CHROMOSOME_POOL_H
+#define GA_CHROMOSOME_POOL_H
+
+/**
+ * @file ga_chromosome_pool.h
+ * @brief Fixed-capacity arena of chromosomes recycled through a free list.
+ * @details
+ * The GA engine keeps at most two generations alive at a time (the parents and the
+ * children being bred), so it can take every population chromosome from a pool sized
+ * once for both: a slab of Chromosome headers and one contiguous gene slab, carved
+ * into chromosomes at creation. Acquiring and releasing a chromosome only moves a
+ * pointer on the free list, so the generational loop does no heap allocation.
+ *
+ * Each header and each gene array starts on its own GA_CACHE_LINE, so workers breeding
+ * or scoring neighbouring chromosomes never write into the same line.
+ *
+ * A pool is not thread-safe: it must be used by one thread at a time (the GA thread, or
+ * the island thread that owns it in asynchronous mode). Its chromosomes must never be
+ * passed to chromosome_destroy().
+ *
+ * @path includes/genetic_algorithm/ga_chromosome_pool.h
+ */
+
+#include <stddef.h>
+#include "genetic_structs.h"
+
+typedef struct GAChromosomePool GAChromosomePool;
+
+/**
+ * @brief Creates a pool of @p capacity chromosomes of @p n_shapes genes each.
+ *
+ * @param capacity Maximum number of chromosomes acquired at the same time.
+ * @param n_shapes Number of genes of every chromosome.
+ * @return New pool with every chromosome free, or NULL if an argument is 0 or on
+ *         allocation failure.
+ */
+GAChromosomePool *ga_chromosome_pool_create(size_t capacity, size_t n_shapes);
+
+/**
+ * @brief Frees the pool (may be NULL) and every chromosome in it, acquired or not.
+ */
+void ga_chromosome_pool_destroy(GAChromosomePool *pool);
+
+/**
+ * @brief Takes a free chromosome out of the pool.
+ *
+ * The chromosome is reset like a new one from chromosome_create() (no parent, fitness
+ * INFINITY, dirty) except for its genes, which keep whatever they last held.
+ *
+ * @param pool Pool to take from.
+ * @return The chromosome, or NULL if all @p capacity chromosomes are in use.
+ */
+Chromosome *ga_chromosome_pool_acquire(GAChromosomePool *pool);
+
+/**
+ * @brief Returns a chromosome obtained from ga_chromosome_pool_acquire() to the pool.
+ *
+ * @param pool Pool the chromosome was acquired from.
+ * @param c    Chromosome to recycle (may be NULL).
+ */
+void ga_chromosome_pool_release(GAChromosomePool *pool, Chromosome *c);
+
+#endif /* GA_CHROMOSOME_POOL_H */
@@ -0,0 +1,78 @@
+#ifndef GA_FITNESS_CACHE_H
+#define GA_FITNESS_CACHE_H
+
+/**
+ * @file ga_fitness_cache.h
+ * @brief Fixed-size genome hash -> fitness cache shared by the evaluation workers.
+ * @details
+ * Selection keeps producing chromosomes whose genome already exists elsewhere in the
+ * population (both tournaments picking the same parent, migrants, crossovers of two
+ * identical parents). When the fitness function is a pure function of the genes, such
+ * a chromosome can take the fitness recorded for its genome instead of being rendered.
+ *
+ * The cache is direct-mapped: a 64-bit genome hash selects one slot, and a newer entry
+ * simply replaces the older one. Each slot is guarded by its own sequence lock, so
+ * lookups never block and never take a lock; a store that finds its slot being written
+ * by another worker is dropped. Genomes are not compared; instead each slot also keeps
+ * a second, independent 64-bit hash of its genome, and a hit needs both hashes to
+ * match, so a collision on the slot hash alone cannot return another genome's fitness.
+ *
+ * @path includes/genetic_algorithm/ga_fitness_cache.h
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct GAFitnessCache GAFitnessCache;
+
+/**
+ * @brief Cache key of a genome.
+ */
+typedef struct {
+    uint64_t hash;  /**< Selects the slot (see chromosome_hash()). */
+    uint64_t check; /**< Independent hash confirming a hit (see chromosome_check_hash()). */
+} GAFitnessKey;
+
+/**
+ * @brief Creates an empty cache.
+ *
+ * @param slots Number of slots, rounded up to a power of two.
+ * @return New cache, or NULL if @p slots is 0 or on allocation failure.
+ */
+GAFitnessCache *ga_fitness_cache_create(size_t slots);
+
+/**
+ * @brief Frees the cache (may be NULL).
+ */
+void ga_fitness_cache_destroy(GAFitnessCache *cache);
+
+/**
+ * @brief Forgets every entry.
+ *
+ * Must not run concurrently with lookups or stores (the GA thread calls it while the
+ * workers wait on their barrier, when the fitness landscape changes).
+ */
+void ga_fitness_cache_clear(GAFitnessCache *cache);
+
+/**
+ * @brief Looks up the fitness recorded for a genome.
+ *
+ * Safe to call from any number of threads, concurrently with stores.
+ *
+ * @param cache Cache to search.
+ * @param key   Genome key; both hashes must match the slot's.
+ * @param[out] fitness Recorded fitness, on a hit.
+ * @return Non-zero on a hit.
+ */
+int ga_fitness_cache_lookup(const GAFitnessCache *cache, const GAFitnessKey *key,
+                            double *fitness);
+
+/**
+ * @brief Records the fitness of a genome, replacing the slot's previous entry.
+ *
+ * Safe to call from any number of threads; the store is skipped if another thread is
+ * writing the same slot.
+ */
+void ga_fitness_cache_store(GAFitnessCache *cache, const GAFitnessKey *key, double fitness);
+
+#endif /* GA_FITNESS_CACHE_H */
@@ -0,0 +1,38 @@
+#ifndef GA_FITNESS_SCAN_H
+#define GA_FITNESS_SCAN_H
+
+/**
+ * @file ga_fitness_scan.h
+ * @brief Best / worst searches over a contiguous array of fitness values.
+ * @details
+ * The GA keeps the fitness of every population slot in a double array indexed in
+ * parallel with the Chromosome* array, so selection, migration and best tracking scan
+ * plain memory instead of following one pointer per chromosome. On x86-64 the scans
+ * process two slots per SSE2 instruction (part of the baseline instruction set, so no
+ * runtime dispatch is needed); other targets use the scalar loop. Both return the
+ * first index holding the extreme value, like a left-to-right strict comparison.
+ *
+ * @path includes/genetic_algorithm/ga_fitness_scan.h
+ */
+
+/**
+ * @brief Index of the lowest (best) fitness in fit[start..end].
+ *
+ * @param fit   Fitness array.
+ * @param start Starting index (inclusive).
+ * @param end   Ending index (inclusive), at least @p start.
+ * @return First index of the minimum.
+ */
+int ga_fitness_argmin(const double *fit, int start, int end);
+
+/**
+ * @brief Index of the highest (worst) fitness in fit[start..end].
+ *
+ * @param fit   Fitness array.
+ * @param start Starting index (inclusive).
+ * @param end   Ending index (inclusive), at least @p start.
+ * @return First index of the maximum.
+ */
+int ga_fitness_argmax(const double *fit, int start, int end);
+
+#endif /* GA_FITNESS_SCAN_H */
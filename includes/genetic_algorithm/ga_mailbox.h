@@ -0,0 +1,52 @@
+#ifndef GA_MAILBOX_H
+#define GA_MAILBOX_H
+
+/**
+ * @file ga_mailbox.h
+ * @brief Bounded single-producer / single-consumer pointer queue for island migration.
+ * @details
+ * In asynchronous island mode every island runs on its own thread and hands migrants to
+ * the next island through a mailbox. Exactly one thread pushes into a given mailbox and
+ * exactly one thread pops from it, which allows a lock-free ring buffer: the producer
+ * only writes the tail index, the consumer only writes the head index, and each index
+ * lives on its own cache line. Neither side ever blocks: pushing into a full mailbox
+ * fails and popping from an empty one returns NULL.
+ *
+ * @path includes/genetic_algorithm/ga_mailbox.h
+ */
+
+#include <stddef.h>
+
+typedef struct GAMailbox GAMailbox;
+
+/**
+ * @brief Creates an empty mailbox.
+ *
+ * @param capacity Number of items it can hold, rounded up to a power of two.
+ * @return New mailbox, or NULL if @p capacity is 0 or on allocation failure.
+ */
+GAMailbox *ga_mailbox_create(size_t capacity);
+
+/**
+ * @brief Frees the mailbox (may be NULL). Items still queued are not freed.
+ */
+void ga_mailbox_destroy(GAMailbox *box);
+
+/**
+ * @brief Appends an item (producer thread only).
+ *
+ * @param box  Mailbox to push into.
+ * @param item Non-NULL pointer to hand over.
+ * @return Non-zero on success, 0 if the mailbox is full (ownership stays with the caller).
+ */
+int ga_mailbox_push(GAMailbox *box, void *item);
+
+/**
+ * @brief Removes the oldest item (consumer thread only).
+ *
+ * @param box Mailbox to pop from.
+ * @return The item, or NULL if the mailbox is empty.
+ */
+void *ga_mailbox_pop(GAMailbox *box);
+
+#endif /* GA_MAILBOX_H */
@@ -0,0 +1,83 @@
+#ifndef GA_RANDOM_H
+#define GA_RANDOM_H
+
+/**
+ * @file ga_random.h
+ * @brief Small, fast pseudo-random streams (xoshiro256++) for the GA operators.
+ * @details
+ * Every stream is an independent GARandom state derived from a run seed and a stream
+ * number, so that concurrent threads never share generator state and a run can be
+ * replayed from its seed. Streams are cheap to create (four splitmix64 steps), which
+ * lets the engine give each island, thread or even each bred slot its own stream.
+ *
+ * Bounded integers use Lemire's multiply-and-reject method (unbiased, almost never
+ * divides) instead of the biased `rand() % n`.
+ *
+ * @path includes/genetic_algorithm/ga_random.h
+ */
+
+#include <stdint.h>
+
+/**
+ * @brief State of one xoshiro256++ stream. Never all zero once seeded.
+ */
+typedef struct GARandom {
+    uint64_t s[4];
+} GARandom;
+
+/**
+ * @brief Seeds stream @p stream of run @p seed.
+ *
+ * Distinct (seed, stream) pairs give unrelated sequences; the same pair always gives
+ * the same sequence.
+ *
+ * @param r      State to initialize.
+ * @param seed   Run seed (GAParams.seed).
+ * @param stream Stream number (island, thread, slot...).
+ */
+void ga_random_seed(GARandom *r, uint64_t seed, uint64_t stream);
+
+/**
+ * @brief Returns the next 64 random bits of the stream.
+ */
+static inline uint64_t ga_random_next(GARandom *r)
+{
+    uint64_t *s = r->s;
+    uint64_t x = s[0] + s[3];
+    uint64_t result = ((x << 23) | (x >> 41)) + s[0];
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 45) | (s[3] >> 19);
+    return result;
+}
+
+/**
+ * @brief Returns a uniform integer in [0, @p bound) (@p bound > 0), without modulo bias.
+ */
+static inline uint32_t ga_random_below(GARandom *r, uint32_t bound)
+{
+    uint64_t m = (uint64_t)(uint32_t)(ga_random_next(r) >> 32) * bound;
+    uint32_t low = (uint32_t)m;
+    if (low < bound) {
+        uint32_t threshold = (uint32_t)(0u - bound) % bound;
+        while (low < threshold) {
+            m = (uint64_t)(uint32_t)(ga_random_next(r) >> 32) * bound;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+/**
+ * @brief Returns a uniform float in [0, 1) with 24 random bits.
+ */
+static inline float ga_random_float(GARandom *r)
+{
+    return (float)(ga_random_next(r) >> 40) * 0x1.0p-24f;
+}
+
+#endif /* GA_RANDOM_H */
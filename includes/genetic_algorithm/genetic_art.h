@@ -7,18 +7,102 @@
 #include <pthread.h>
 #include <stdatomic.h>
 
+/**
+ * @brief Alignment (in bytes) of every per-worker evaluation buffer.
+ *
+ * Matches the cache line size of the targeted x86/ARM CPUs so that two workers
+ * never write into the same line (no false sharing) and SIMD loads stay aligned.
+ */
+#define GA_CACHE_LINE 64
+
+/**
+ * @brief Per-worker evaluation context handed to the fitness function.
+ *
+ * The GA engine owns one GAEvalContext per evaluation worker. Each context
+ * carries a private, GA_CACHE_LINE-aligned scratch area of
+ * GAContext.eval_scratch_size bytes, so that concurrent fitness evaluations
+ * never share a render canvas.
+ */
+typedef struct GAEvalContext {
+    int     worker_id;    /**< Index of the evaluating worker in [0..worker_count);
+                               worker_count for the GA thread's own context. */
+    int     worker_count; /**< Number of evaluation workers owned by the engine. */
+    void   *scratch;      /**< Worker-private scratch memory (GA_CACHE_LINE aligned). */
+    size_t  scratch_size; /**< Size of @p scratch in bytes. */
+} GAEvalContext;
+
 /**
  * @brief Function pointer type for GA fitness evaluation.
  *
  * The GA engine calls this function to obtain the fitness of a Chromosome.
  * The user_data pointer is passed through from GAContext and can be used
- * to provide access to evaluation buffers or constants.
+ * to provide access to read-only evaluation data (reference image, constants).
+ * Any per-evaluation working memory must come from @p ectx, which is private
+ * to the calling worker thread.
  *
  * @param c         Pointer to the Chromosome to be evaluated.
  * @param user_data Opaque pointer to user data, as provided in the GAContext.
+ * @param ectx      Evaluation context of the calling worker.
  * @return The computed fitness value (lower is better).
  */
-typedef double (*GAFitnessFunc)(const Chromosome *c, void *user_data);
+typedef double (*GAFitnessFunc)(const Chromosome *c, void *user_data,
+                                const GAEvalContext *ectx);
+
+/**
+ * @brief Function pointer type for batched GA fitness evaluation.
+ *
+ * Evaluates several chromosomes in one call, so that an implementation can
+ * amortize per-call setup or share work across the batch. Each evaluation
+ * worker calls it once per generation with its whole slice of the population.
+ * Same contract as GAFitnessFunc otherwise: @p user_data is read-only, working
+ * memory comes from @p ectx.
+ *
+ * @param cs        Chromosomes to evaluate.
+ * @param fitness   Output array: fitness[i] receives the fitness of cs[i] (lower is better).
+ * @param count     Number of chromosomes in @p cs (and entries in @p fitness).
+ * @param user_data Opaque pointer to user data, as provided in the GAContext.
+ * @param ectx      Evaluation context of the calling worker.
+ */
+typedef void (*GABatchFitnessFunc)(const Chromosome *const *cs, double *fitness, size_t count,
+                                   void *user_data, const GAEvalContext *ectx);
+
+/**
+ * @brief Function pointer type for the optional pre-evaluation optimization step.
+ *
+ * Called by the evaluating worker on each chromosome right before its fitness is
+ * computed. Unlike GAFitnessFunc it may modify the chromosome's genes (e.g. to give
+ * a mutated shape its best color), and the fitness computed next reflects the
+ * modified genes. c->parent, when set, is valid during the call. Same threading
+ * contract as GAFitnessFunc.
+ *
+ * @param c         Chromosome about to be evaluated.
+ * @param user_data Opaque pointer to user data, as provided in the GAContext.
+ * @param ectx      Evaluation context of the calling worker.
+ */
+typedef void (*GAOptimizeFunc)(Chromosome *c, void *user_data, const GAEvalContext *ectx);
+
+/**
+ * @brief Summary of a finished generation, passed to GAGenerationFunc.
+ */
+typedef struct GAGenerationInfo {
+    int    iteration;     /**< Index of the generation that was just evaluated (0 = initial population). */
+    double best_fitness;  /**< Lowest fitness found so far under the current fitness landscape. */
+} GAGenerationInfo;
+
+/**
+ * @brief Function pointer type for the per-generation hook.
+ *
+ * Called by the GA thread between generations, while no fitness evaluation is
+ * running, so the callee may safely modify the data behind @p user_data (e.g.
+ * switch the fitness function to another resolution).
+ *
+ * @param info      Summary of the generation that was just evaluated.
+ * @param user_data The GAContext fitness_data pointer.
+ * @return Non-zero if fitness values computed so far are no longer comparable with
+ *         new ones; the engine then re-evaluates the whole population and restarts
+ *         best tracking from the re-evaluated values.
+ */
+typedef int (*GAGenerationFunc)(const GAGenerationInfo *info, void *user_data);
 
 /**
  * @brief Enum for log message severity level.
@@ -63,6 +147,8 @@ typedef struct GAContext {
     /**
      * @brief Memory management function to allocate a new Chromosome.
      * The function must create a Chromosome with space for @p n_shapes genes.
+     * Used for best_snapshot and for migrant copies in asynchronous mode only: the
+     * population itself lives in a pool owned by the engine (see ga_chromosome_pool.h).
      */
     Chromosome        *(*alloc_chromosome)(size_t n_shapes);
 
@@ -86,11 +172,49 @@ typedef struct GAContext {
      */
     GAFitnessFunc       fitness_func;
 
+    /**
+     * @brief Optional batched fitness evaluation (may be NULL).
+     * When set, workers evaluate their slice with it instead of calling fitness_func
+     * once per chromosome; fitness_func remains the per-item fallback.
+     */
+    GABatchFitnessFunc  batch_fitness_func;
+
+    /**
+     * @brief Optional step (may be NULL) run on each chromosome before its evaluation,
+     * called with fitness_data; it may rewrite genes in place.
+     */
+    GAOptimizeFunc      optimize_func;
+
     /**
      * @brief Opaque pointer to user-defined fitness data.
      */
     void               *fitness_data;
 
+    /**
+     * @brief Optional exact fitness (may be NULL), used when fitness_func is an estimate.
+     * The GA thread re-scores each new best with it before publishing best_snapshot.
+     */
+    GAFitnessFunc       exact_fitness_func;
+
+    /**
+     * @brief Size in bytes of the scratch area allocated for each evaluation worker.
+     * The engine allocates it (GA_CACHE_LINE aligned) and passes it through GAEvalContext.
+     */
+    size_t              eval_scratch_size;
+
+    /**
+     * @brief Slots of the genome hash -> fitness cache shared by the workers (0 disables it).
+     * Only valid when fitness_func (after optimize_func) depends on nothing but the genes
+     * until generation_func reports a change of fitness landscape.
+     */
+    size_t              fitness_cache_slots;
+
+    /**
+     * @brief Optional per-generation hook (may be NULL), called with fitness_data.
+     * Not called in asynchronous island mode, where islands never pause together.
+     */
+    GAGenerationFunc    generation_func;
+
     /**
      * @brief Optional logging interface.
      */
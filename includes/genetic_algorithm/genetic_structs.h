@@ -19,6 +19,7 @@
  */
 
 #include <stddef.h> /**< Provides size_t type for portable size representation. */
+#include <stdint.h> /**< Provides int16_t for packed genes and uint64_t for gene hashing. */
 
 /**
  * @brief Parameters controlling the behavior of the Genetic Algorithm.
@@ -29,10 +30,20 @@
 typedef struct {
     int   population_size; /**< Number of chromosomes (candidate solutions) maintained in each generation. */
     int   nb_shapes;       /**< Number of genes (primitive shapes) composing each chromosome. */
-    int   elite_count;     /**< Number of top-performing chromosomes directly carried to the next generation. */
+    int   elite_count;     /**< Number of top-performing chromosomes of each island carried to the next generation
+                               unchanged (without re-evaluation); at least 1 is always kept. */
     float mutation_rate;   /**< Probability [0, 1] of mutating a gene during evolution. */
     float crossover_rate;  /**< Probability [0, 1] that two parent chromosomes will crossover. */
     int   max_iterations;  /**< Maximum number of generations to run before termination. */
+    int   island_count;        /**< Number of islands the population is split into (0 = engine default). */
+    int   migration_interval;  /**< Generations between ring migrations (0 = engine default). */
+    int   migrants_per_island; /**< Best chromosomes each island sends to the next one (0 = engine default). */
+    int   worker_count;        /**< Fitness evaluation threads, independent of the islands (0 = one per island). */
+    int   async_islands;       /**< Non-zero: each island evolves on its own thread, without lockstep
+                                    generations, and migrates through lock-free mailboxes (worker_count
+                                    and the per-generation hook are then unused). */
+    uint64_t seed;             /**< Run seed: every random stream of the GA derives from it, so a seed
+                                    replays the same run (lockstep mode). */
 } GAParams;
 
 /**
@@ -45,24 +56,45 @@ typedef enum {
     SHAPE_TRIANGLE    /**< Triangular shape (three vertices). */
 } ShapeType;
 
+/**
+ * @brief Marks a circle gene: value of its `tag` field, never a valid triangle y2.
+ */
+#define GENE_CIRCLE_TAG INT16_MIN
+
 /**
  * @brief Representation of a single gene, corresponding to a colored geometric shape.
  *
- * A gene defines a drawable primitive (circle or triangle) with associated color information.
- * The shape-specific data is stored in a union to minimize memory usage.
+ * A gene defines a drawable primitive (circle or triangle) with associated color information,
+ * packed into 16 bytes: coordinates fit in int16 (the canvas is at most 640x480) and the
+ * shape type costs no extra byte. A circle stores GENE_CIRCLE_TAG where a triangle stores
+ * its y2 (always >= 0), and leaves the last two coordinates at zero; use gene_type() to
+ * tell the two apart. Genes are plain data: copies and comparisons are bytewise.
  */
 typedef struct {
-    ShapeType type; /**< Type of geometric primitive (circle or triangle). */
     union {
-        struct { int cx, cy, radius; } circle;          /**< Circle parameters: center coordinates and radius length. */
-        struct { int x1, y1, x2, y2, x3, y3; } triangle; /**< Triangle parameters: coordinates of three vertices. */
-    } geom; /**< Geometric data describing the shape depending on `type`. */
+        struct { int16_t cx, cy, radius, tag; } circle;      /**< Circle parameters: center coordinates, radius length and GENE_CIRCLE_TAG. */
+        struct { int16_t x1, y1, x2, y2, x3, y3; } triangle; /**< Triangle parameters: coordinates of three vertices. */
+    } geom; /**< Geometric data describing the shape depending on gene_type(). */
     unsigned char r; /**< Red color channel value (0–255). */
     unsigned char g; /**< Green color channel value (0–255). */
     unsigned char b; /**< Blue color channel value (0–255). */
     unsigned char a; /**< Alpha (opacity) channel value (0–255). */
 } Gene;
 
+_Static_assert(sizeof(Gene) == 16, "Gene must stay packed in 16 bytes");
+
+/**
+ * @brief Returns the type of primitive drawn by a gene.
+ *
+ * @param[in] g Gene to inspect.
+ *
+ * @return SHAPE_CIRCLE if the gene carries GENE_CIRCLE_TAG, SHAPE_TRIANGLE otherwise.
+ */
+static inline ShapeType gene_type(const Gene *g)
+{
+    return g->geom.circle.tag == GENE_CIRCLE_TAG ? SHAPE_CIRCLE : SHAPE_TRIANGLE;
+}
+
 /**
  * @brief Represents a candidate solution composed of multiple genes.
  *
@@ -70,10 +102,17 @@ typedef struct {
  * graphical solution. Chromosomes are subject to evaluation, mutation, and crossover
  * operations during the Genetic Algorithm process.
  */
-typedef struct {
+typedef struct Chromosome {
     Gene   *shapes;   /**< Pointer to a contiguous array of genes composing the chromosome. */
     size_t  n_shapes; /**< Number of genes contained in the chromosome (matches GAParams.nb_shapes). */
     double  fitness;  /**< Fitness score indicating solution quality; lower values represent better fitness. */
+    const struct Chromosome *parent; /**< Evaluated chromosome this one was bred from, or NULL.
+                                          Only valid until this chromosome has been evaluated;
+                                          lets the fitness function re-score the changed area only. */
+    double  parent_fitness; /**< Fitness of @p parent when this chromosome was bred (its genes are
+                                 read-only during evaluation, its fitness field may be rewritten). */
+    int     dirty;    /**< Non-zero while @p fitness does not match the genes (new or changed genome,
+                           or fitness landscape changed); clean chromosomes are not re-evaluated. */
 } Chromosome;
 
 /**
@@ -121,4 +160,40 @@ void chromosome_destroy(Chromosome *c);
  */
 void copy_chromosome(Chromosome *dst, const Chromosome *src);
 
+/**
+ * @brief Fold a gene into a running 64-bit hash.
+ *
+ * Only the fields meaningful for the gene's shape type are hashed (unused union
+ * bytes are ignored), so two genes that draw the same shape always hash alike.
+ * Chaining the calls over a gene array yields a hash of every prefix:
+ * h(k+1) = gene_hash(h(k), &genes[k]).
+ *
+ * @param[in] h Hash of the preceding genes (or a seed for the first one).
+ * @param[in] g Gene to fold in.
+ *
+ * @return The updated hash.
+ */
+uint64_t gene_hash(uint64_t h, const Gene *g);
+
+/**
+ * @brief Hash of a whole genome (gene count and every gene, in order).
+ *
+ * @param[in] c Chromosome to hash.
+ *
+ * @return 64-bit hash; equal genomes always hash alike.
+ */
+uint64_t chromosome_hash(const Chromosome *c);
+
+/**
+ * @brief Second hash of a whole genome, computed independently of chromosome_hash().
+ *
+ * Lets a hash table confirm a chromosome_hash() match (see ga_fitness_cache.h):
+ * two different genomes collide on both only with probability about 2^-128.
+ *
+ * @param[in] c Chromosome to hash.
+ *
+ * @return 64-bit hash; equal genomes always hash alike.
+ */
+uint64_t chromosome_check_hash(const Chromosome *c);
+
 #endif /* GENETIC_STRUCTS_H */
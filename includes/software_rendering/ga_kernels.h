@@ -0,0 +1,95 @@
+#ifndef GA_KERNELS_H
+#define GA_KERNELS_H
+
+/**
+ * @file ga_kernels.h
+ * @brief Pixel kernels of the software renderer, with runtime CPU dispatch.
+ * @details
+ * The innermost loops of the renderer (span blending and squared-error reduction)
+ * exist in several variants: portable scalar C, SSE4.1, AVX2 and AVX-512BW. Each SIMD variant
+ * lives in its own translation unit, compiled with the matching target flags, so a
+ * single binary carries all of them. ga_kernels_select() picks the best variant of
+ * every function from the SysCapabilities detected at startup; until it is called,
+ * the scalar kernels are used.
+ *
+ * @path includes/software_rendering/ga_kernels.h
+ */
+
+#include <SDL2/SDL.h>
+#include "../tools/system_tools.h"
+
+/** @brief Defined when the SIMD kernel variants are compiled in (x86-64 targets). */
+#if defined(__x86_64__) || defined(_M_X64)
+  #define GA_KERNELS_X86 1
+#endif
+
+/**
+ * @brief Per-shape blend constants, computed once per gene instead of once per pixel.
+ *
+ * For ARGB8888 canvases the source channels are premultiplied by alpha so that blending
+ * a pixel is dst' = (src * a + dst * (255 - a)) / 255 in pure integer arithmetic.
+ */
+typedef struct {
+    Uint32 col;     /**< Source color mapped to the canvas format (generic path). */
+    Uint32 pr;      /**< Red   * alpha. */
+    Uint32 pg;      /**< Green * alpha. */
+    Uint32 pb;      /**< Blue  * alpha. */
+    Uint32 inv_a;   /**< 255 - alpha. */
+    int    argb;    /**< Non-zero if the canvas is ARGB8888 (integer kernels usable). */
+} BlendColor;
+
+/**
+ * @brief Blends a horizontal run of @p n ARGB8888 pixels with the color in @p bc.
+ * Output alpha is forced to 255. Every variant produces bit-identical pixels.
+ */
+typedef void (*GABlendSpanFunc)(Uint32 *px, int n, const BlendColor *bc);
+
+/**
+ * @brief Returns the sum of squared RGB differences between @p n pixels of two ARGB buffers.
+ * The sum is exact (an integer, not normalized) and identical across variants.
+ */
+typedef Uint64 (*GASseSpanFunc)(const Uint32 *cand, const Uint32 *ref, int n);
+
+/**
+ * @brief Dispatch table holding the selected variant of every kernel.
+ */
+typedef struct {
+    GABlendSpanFunc blend_span;      /**< Span blending kernel. */
+    GASseSpanFunc   sse_span;        /**< Squared-error reduction kernel. */
+    const char     *blend_span_name; /**< Name of the selected blend variant ("scalar", "avx2"...). */
+    const char     *sse_span_name;   /**< Name of the selected squared-error variant. */
+} GAKernels;
+
+/**
+ * @brief Returns the active kernel table (scalar kernels until ga_kernels_select() runs).
+ */
+const GAKernels *ga_kernels(void);
+
+/**
+ * @brief Selects the fastest kernel variants supported by the running CPU.
+ *
+ * Must be called once at startup, before any rendering thread is started. Each SIMD
+ * variant is checked against the scalar kernel on pseudo-random data first; a variant
+ * whose output differs in any bit is not selected.
+ *
+ * @param caps Detected capabilities (NULL selects the scalar kernels).
+ */
+void ga_kernels_select(const SysCapabilities *caps);
+
+/* ---- Variant entry points (one translation unit per instruction set) ---- */
+
+void   ga_blend_span_scalar(Uint32 *px, int n, const BlendColor *bc);
+Uint64 ga_sse_span_scalar(const Uint32 *cand, const Uint32 *ref, int n);
+
+#ifdef GA_KERNELS_X86
+void   ga_blend_span_sse41(Uint32 *px, int n, const BlendColor *bc);
+Uint64 ga_sse_span_sse41(const Uint32 *cand, const Uint32 *ref, int n);
+
+void   ga_blend_span_avx2(Uint32 *px, int n, const BlendColor *bc);
+Uint64 ga_sse_span_avx2(const Uint32 *cand, const Uint32 *ref, int n);
+
+void   ga_blend_span_avx512(Uint32 *px, int n, const BlendColor *bc);
+Uint64 ga_sse_span_avx512(const Uint32 *cand, const Uint32 *ref, int n);
+#endif
+
+#endif /* GA_KERNELS_H */
@@ -1,22 +1,66 @@
 #ifndef GA_RENDERER_H
 #define GA_RENDERER_H
 
-#include "../genetic_algorithm/genetic_structs.h"
+#include "../genetic_algorithm/genetic_art.h"
+#include "ga_kernels.h"
 #include <SDL2/SDL.h>
 
+/** @brief Maximum number of levels in a GAImagePyramid (level 0 included). */
+#define GA_PYRAMID_MAX_LEVELS 6
+
+/**
+ * @brief Mip chain of an ARGB8888 reference image.
+ *
+ * Level 0 is the full-resolution image; each further level halves both dimensions
+ * (2x2 box filter). Every level is stored tightly packed (pitch = width * 4).
+ */
+typedef struct {
+    const Uint32 *levels[GA_PYRAMID_MAX_LEVELS]; /**< Pixels of each level (level 0 is not owned). */
+    int width[GA_PYRAMID_MAX_LEVELS];            /**< Width of each level in pixels. */
+    int height[GA_PYRAMID_MAX_LEVELS];           /**< Height of each level in pixels. */
+    int count;                                   /**< Number of valid levels (0 if not built). */
+} GAImagePyramid;
+
+/**
+ * @brief Summed-area tables of the reference RGB channels, one per pyramid level.
+ *
+ * Built once by ga_color_tables_create(); read-only afterwards, so all workers share them.
+ */
+typedef struct GAColorTables GAColorTables;
+
 /**
  * @brief Parameters used for calculating chromosome fitness with SDL rendering.
  *
- * This structure holds all necessary buffers and information required for 
- * fitness calculation and rendering of chromosomes.
+ * This structure holds the read-only information shared by all evaluation
+ * workers. The render canvas itself is not part of it: each worker renders into
+ * the private scratch area of its GAEvalContext (see ga_fitness_scratch_size()).
  */
 typedef struct {
     const Uint32 *ref_pixels;          /**< Pointer to reference pixel buffer (ARGB format). */
-    Uint32       *scratch_pixels;      /**< Pointer to temporary rendering pixel buffer (ARGB). */
     const SDL_PixelFormat *fmt;        /**< SDL PixelFormat used for correct pixel manipulation. */
     int pitch;                         /**< Number of bytes per row (typically width * 4). */
     int width;                         /**< Width of the rendering area in pixels. */
     int height;                        /**< Height of the rendering area in pixels. */
+    int incremental;                   /**< Non-zero: re-score children only inside the bounding box
+                                            of the genes that differ from their parent. */
+
+    /* Optimal-color solving (see ga_sdl_solve_colors_callback()); inactive when color_tables is NULL. */
+    GAColorTables *color_tables;       /**< Summed-area tables of the reference levels. */
+    int color_solve_max_genes;         /**< Children changing more genes than this keep their colors. */
+
+    /* Coarse-to-fine (pyramid) mode; inactive when pyramid is NULL. */
+    const GAImagePyramid *pyramid;     /**< Mip chain of ref_pixels (ARGB8888 canvases only). */
+    int level;                         /**< Pyramid level currently evaluated (0 = full resolution). */
+
+    /* Row-subsampled fitness: one row per band of 2^sample_shift rows is rasterized and scored. */
+    int sample_shift_max;              /**< Band size (log2) used when a level is entered. */
+    int sample_shift;                  /**< Current band size (log2); 0 scores every row. */
+
+    /* Progressive refinement schedule (see ga_refine_generation_callback()). */
+    int stall_generations;             /**< Generations without improvement before refining. */
+    double stall_tolerance;            /**< Relative best-fitness gain that counts as improvement. */
+    double stall_best;                 /**< Best fitness when the stall counter was last reset. */
+    int stall_count;                   /**< Generations since the last improvement. */
 } GAFitnessParams;
 
 /**
@@ -24,10 +68,21 @@ typedef struct {
  *
  * Renders the given chromosome to a temporary buffer, then compares it with a 
  * reference image pixel-by-pixel using Mean Squared Error on RGB channels.
- * Optionally optimized with AVX2 instructions if available.
+ * Blending and error reduction go through the CPU-dispatched kernels of ga_kernels.h.
+ *
+ * When GAFitnessParams.incremental is set and the chromosome records an evaluated
+ * parent, only the union bounding box of the genes that differ from the parent is
+ * recomposited (for both), and the parent's error is corrected by the difference.
+ *
+ * In pyramid mode the chromosome is rendered at GAFitnessParams.level and compared
+ * with the matching mip level. While GAFitnessParams.sample_shift is non-zero the MSE
+ * is estimated from a fixed, stratified subset of rows, and only those rows are
+ * rasterized (see ga_refine_generation_callback()).
  *
  * @param c         Pointer to the chromosome whose fitness is evaluated.
  * @param user_data Pointer to GAFitnessParams structure containing necessary buffers.
+ * @param ectx      Evaluation context of the calling worker; its scratch area
+ *                  (at least ga_fitness_scratch_size() bytes) is used as canvas.
  *
  * @return The computed fitness as a double precision floating point (MSE value).
  *
@@ -35,11 +90,123 @@ typedef struct {
  *
  * Example:
  * @code
- * ctx.fitness_func = ga_sdl_fitness_callback;
- * ctx.fitness_user_data = &fitness_params;
+ * ctx.fitness_func      = ga_sdl_fitness_callback;
+ * ctx.fitness_data      = &fitness_params;
+ * ctx.eval_scratch_size = ga_fitness_scratch_size(&fitness_params);
  * @endcode
  */
-double ga_sdl_fitness_callback(const Chromosome *c, void *user_data);
+double ga_sdl_fitness_callback(const Chromosome *c, void *user_data,
+                               const GAEvalContext *ectx);
+
+/**
+ * @brief Batched variant of ga_sdl_fitness_callback(), evaluating a worker's whole slice.
+ *
+ * The parameters are validated and the evaluated level and row sampling resolved once
+ * per batch; each chromosome then gets exactly the score ga_sdl_fitness_callback()
+ * would return (1.0e30 for NULL entries or unusable parameters).
+ *
+ * @note Intended to be set as GAContext.batch_fitness_func, next to fitness_func.
+ */
+void ga_sdl_batch_fitness_callback(const Chromosome *const *cs, double *fitness, size_t count,
+                                   void *user_data, const GAEvalContext *ectx);
+
+/**
+ * @brief Exact variant of ga_sdl_fitness_callback(): every row of the current level is scored.
+ *
+ * @note Intended to be set as GAContext.exact_fitness_func, so that the published best
+ *       is never ranked on a sampled estimate.
+ */
+double ga_sdl_exact_fitness_callback(const Chromosome *c, void *user_data,
+                                     const GAEvalContext *ectx);
+
+/**
+ * @brief Gives the genes a child changed the least-squares optimal RGB color.
+ *
+ * For each gene that differs from the parent (in gene order, children changing at most
+ * GAFitnessParams.color_solve_max_genes genes only), the canvas beneath the gene is
+ * composited over its bounding box, at the current pyramid level and row sampling.
+ * Given the gene's coverage and alpha, the color minimizing the squared error of the
+ * blended pixels against the reference is then solved in closed form and written into
+ * the gene (alpha is kept). Reference sums come from the summed-area tables, in O(1)
+ * per covered row; only the canvas beneath is read pixel by pixel.
+ *
+ * Shapes drawn later are ignored, so the color is optimal for the canvas as seen by the
+ * gene rather than for the final image; the fitness computed afterwards is exact.
+ *
+ * @param c         Chromosome about to be evaluated (c->parent set for children).
+ * @param user_data Pointer to GAFitnessParams (color_tables set).
+ * @param ectx      Evaluation context of the calling worker; its canvas is used.
+ *
+ * @note Intended to be set as GAContext.optimize_func.
+ */
+void ga_sdl_solve_colors_callback(Chromosome *c, void *user_data, const GAEvalContext *ectx);
+
+/**
+ * @brief Builds the summed-area tables of every reference level used by @p p.
+ *
+ * Level 0 is built from GAFitnessParams.ref_pixels, further levels from the pyramid.
+ *
+ * @param p Fitness parameters (ARGB8888 reference).
+ * @return New tables (release with ga_color_tables_destroy()), or NULL on failure.
+ */
+GAColorTables *ga_color_tables_create(const GAFitnessParams *p);
+
+/**
+ * @brief Frees tables returned by ga_color_tables_create() (NULL is ignored).
+ */
+void ga_color_tables_destroy(GAColorTables *tables);
+
+/**
+ * @brief Generation hook driving progressive refinement (row density, then pyramid level).
+ *
+ * Genes always use full-resolution coordinates; at pyramid level k they are rendered
+ * with coordinates and radii scaled by 2^-k against the matching mip level, so an
+ * evaluation costs about 1/4^k of a full one. Within a level, only one row in
+ * 2^sample_shift is scored at first.
+ *
+ * When the best fitness has not improved by GAFitnessParams.stall_tolerance for
+ * stall_generations generations, the row density is doubled; once every row is scored,
+ * the next finer level is entered with the sparsest density again. Non-zero is returned
+ * on every change so that the engine re-scores the population.
+ *
+ * @param info      Summary of the finished generation.
+ * @param user_data Pointer to GAFitnessParams.
+ * @return Non-zero if the density or the level changed.
+ *
+ * @note Intended to be set as GAContext.generation_func.
+ */
+int ga_refine_generation_callback(const GAGenerationInfo *info, void *user_data);
+
+/**
+ * @brief Builds the mip chain of an ARGB8888 image.
+ *
+ * Level 0 points to @p base (not copied); levels 1..levels-1 are allocated and must be
+ * released with ga_pyramid_free(). Construction stops early if a level would become
+ * smaller than 1x1.
+ *
+ * @param[out] pyr  Pyramid to fill.
+ * @param base      Full-resolution image, tightly packed.
+ * @param width     Width of @p base in pixels.
+ * @param height    Height of @p base in pixels.
+ * @param levels    Requested number of levels (1..GA_PYRAMID_MAX_LEVELS).
+ * @return 0 on success, -1 on invalid parameters or allocation failure.
+ */
+int ga_pyramid_build(GAImagePyramid *pyr, const Uint32 *base, int width, int height, int levels);
+
+/**
+ * @brief Releases the levels allocated by ga_pyramid_build() and resets @p pyr.
+ *
+ * @param pyr Pyramid to free (may be NULL).
+ */
+void ga_pyramid_free(GAImagePyramid *pyr);
+
+/**
+ * @brief Returns the per-worker scratch size required by ga_sdl_fitness_callback().
+ *
+ * @param p Fitness parameters (pitch and height must be set).
+ * @return Number of bytes each GAEvalContext scratch area must provide, or 0 if @p p is invalid.
+ */
+size_t ga_fitness_scratch_size(const GAFitnessParams *p);
 
 /**
  * @brief Renders a chromosome into an ARGB pixel buffer.
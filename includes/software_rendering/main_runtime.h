@@ -19,6 +19,7 @@
 #include <SDL2/SDL.h>            /**< SDL2 library for window, renderer, and event handling. */
 #include <stdatomic.h>           /**< Atomic operations library used for concurrency control. */
 #include "../genetic_algorithm/genetic_art.h" /**< Genetic Algorithm core structures and definitions. */
+#include "ga_renderer.h"         /**< Fitness parameters and reference image pyramid. */
 
 /* Forward declaration of Nuklear context */
 struct nk_context;
@@ -70,18 +71,22 @@ int init_nuklear_and_font(struct nk_context **nk_ctx,
  * @param[in]  renderer    Pointer to the SDL_Renderer used for texture creation.
  * @param[out] fmt         Address of a pointer to SDL_PixelFormat; must be manually freed with SDL_FreeFormat().
  * @param[out] ref_pixels  Address of a pointer to an ARGB8888 buffer representing the reference image.
+ * @param[out] pyramid     Optional (may be NULL) mip chain of @p ref_pixels with PYRAMID_LEVELS levels;
+ *                         release with ga_pyramid_free() before freeing @p ref_pixels.
  *
  * @return SDL_Texture* containing the processed and converted BMP image, or NULL on failure.
  *
  * @details
  * Loads a BMP image from disk. If dimensions differ from (IMAGE_W × IMAGE_H),
  * the image is resized and centered over a black background, then converted
- * to the ARGB8888 pixel format. A pixel buffer copy for fitness computation is also returned.
+ * to the ARGB8888 pixel format. A pixel buffer copy for fitness computation is also returned,
+ * along with its image pyramid for the coarse-to-fine evolution mode.
  */
 SDL_Texture *load_reference_image(const char *filename,
                                   SDL_Renderer *renderer,
                                   SDL_PixelFormat **fmt,
-                                  Uint32 **ref_pixels);
+                                  Uint32 **ref_pixels,
+                                  GAImagePyramid *pyramid);
 
 /**
  * @brief Build and return a fully initialized GAContext structure.
@@ -91,6 +96,11 @@ SDL_Texture *load_reference_image(const char *filename,
  * @param[in] fmt          Pointer to the SDL_PixelFormat describing the buffer layout.
  * @param[in] pitch        Row size in bytes for the ARGB pixel buffers.
  * @param[in] running      Pointer to an atomic integer flag used to control GA execution state.
+ * @param[in] pyramid      Optional mip chain of @p ref_pixels; when it has more than one level,
+ *                         evolution starts at the coarsest level (pyramid mode).
+ * @param[in] worker_count Number of fitness evaluation threads, independent of the island count
+ *                         (typically SysCapabilities.maxThreads).
+ * @param[in] seed         Run seed of the GA's random streams (GAParams.seed).
  *
  * @return A configured GAContext structure ready for Genetic Algorithm operations.
  *
@@ -107,7 +117,10 @@ GAContext build_ga_context(Uint32 *ref_pixels,
                            Uint32 *best_pixels,
                            SDL_PixelFormat *fmt,
                            int pitch,
-                           atomic_int *running);
+                           atomic_int *running,
+                           const GAImagePyramid *pyramid,
+                           int worker_count,
+                           uint64_t seed);
 
 /**
  * @brief Run the main graphical and control loop of the application.
@@ -23,6 +23,7 @@ typedef struct SysCapabilities {
     bool avx;         /**< True if AVX is supported.   */
     bool avx2;        /**< True if AVX2 is supported.  */
     bool avx512;      /**< True if AVX512 is supported.*/
+    bool avx512bw;    /**< True if AVX512BW (byte/word instructions) is supported. */
 
     bool hasOpenGL;   /**< True if OpenGL context creation is possible. */
     bool hasOpenCL;   /**< True if OpenCL platforms are found. */
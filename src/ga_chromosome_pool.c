@@ -0,0 +1,89 @@
+/**
+ * @file ga_chromosome_pool.c
+ * @brief Slab-backed chromosome pool with a LIFO free list (see ga_chromosome_pool.h).
+ *
+ * Headers are padded to a cache line each and gene arrays are spaced by their size
+ * rounded up to a cache line. The free list is a stack of header pointers: the most
+ * recently released chromosome is handed out first, while its lines are still cached.
+ */
+
+#include "../includes/genetic_algorithm/ga_chromosome_pool.h"
+#include "../includes/genetic_algorithm/genetic_art.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    _Alignas(GA_CACHE_LINE) Chromosome c; /**< Header, alone on its cache line(s). */
+} PoolHeader;
+
+struct GAChromosomePool {
+    PoolHeader   *headers;  /**< capacity headers. */
+    Gene         *genes;    /**< Gene slab, gene_stride genes per chromosome. */
+    Chromosome  **free;     /**< Stack of free chromosomes. */
+    size_t        nfree;    /**< Number of entries of @p free. */
+    size_t        capacity; /**< Total number of chromosomes. */
+};
+
+GAChromosomePool *ga_chromosome_pool_create(size_t capacity, size_t n_shapes)
+{
+    if (capacity == 0 || n_shapes == 0 || n_shapes > SIZE_MAX / 2 / sizeof(Gene))
+        return NULL;
+    size_t row = (n_shapes * sizeof(Gene) + GA_CACHE_LINE - 1) & ~(size_t)(GA_CACHE_LINE - 1);
+    if (capacity > SIZE_MAX / (row + sizeof(PoolHeader)))
+        return NULL;
+
+    GAChromosomePool *pool = (GAChromosomePool *)calloc(1, sizeof(GAChromosomePool));
+    if (!pool)
+        return NULL;
+    pool->headers = (PoolHeader *)aligned_alloc(GA_CACHE_LINE, capacity * sizeof(PoolHeader));
+    pool->genes   = (Gene *)aligned_alloc(GA_CACHE_LINE, capacity * row);
+    pool->free    = (Chromosome **)malloc(capacity * sizeof(Chromosome *));
+    if (!pool->headers || !pool->genes || !pool->free) {
+        ga_chromosome_pool_destroy(pool);
+        return NULL;
+    }
+    // Zeroed like chromosome_create(), which also maps the whole slab up front
+    memset(pool->genes, 0, capacity * row);
+
+    pool->capacity = capacity;
+    pool->nfree    = capacity;
+    for (size_t i = 0; i < capacity; i++) {
+        Chromosome *c = &pool->headers[i].c;
+        c->shapes   = (Gene *)((unsigned char *)pool->genes + i * row);
+        c->n_shapes = n_shapes;
+        // Lowest slots on top of the stack, so a fresh pool hands out the slabs in order
+        pool->free[capacity - 1 - i] = c;
+    }
+    return pool;
+}
+
+void ga_chromosome_pool_destroy(GAChromosomePool *pool)
+{
+    if (!pool)
+        return;
+    free(pool->headers);
+    free(pool->genes);
+    free(pool->free);
+    free(pool);
+}
+
+Chromosome *ga_chromosome_pool_acquire(GAChromosomePool *pool)
+{
+    if (!pool || pool->nfree == 0)
+        return NULL;
+    Chromosome *c = pool->free[--pool->nfree];
+    c->fitness        = INFINITY;
+    c->parent         = NULL;
+    c->parent_fitness = INFINITY;
+    c->dirty          = 1;
+    return c;
+}
+
+void ga_chromosome_pool_release(GAChromosomePool *pool, Chromosome *c)
+{
+    if (!pool || !c || pool->nfree == pool->capacity)
+        return;
+    pool->free[pool->nfree++] = c;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file ga_fitness_cache.c
+ * @brief Direct-mapped, lock-free genome hash -> fitness cache (one sequence lock per slot).
+ *
+ * A slot's sequence number is even when the slot is stable and odd while a writer
+ * updates it; 0 marks a slot never written. Readers load the sequence, the payload and
+ * the sequence again, and only trust the payload if both sequence loads match and are
+ * even. Writers claim a slot by moving its sequence from even to odd with a CAS, so at
+ * most one writer updates a slot at a time and competing stores are simply dropped.
+ * Payload fields are atomics accessed with relaxed ordering, so torn reads are detected
+ * by the sequence check rather than being data races.
+ */
+
+#include "../includes/genetic_algorithm/ga_fitness_cache.h"
+#include "../includes/genetic_algorithm/genetic_art.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    atomic_uint      seq;   /**< Sequence lock: odd while being written, 0 if never written. */
+    _Atomic uint64_t key;   /**< Genome hash (GAFitnessKey::hash). */
+    _Atomic uint64_t check; /**< Second genome hash (GAFitnessKey::check). */
+    _Atomic uint64_t bits;  /**< Fitness, as the bit pattern of a double. */
+} FitnessSlot;
+
+struct GAFitnessCache {
+    size_t       mask;  /**< Slot count - 1 (slot count is a power of two). */
+    FitnessSlot *slots; /**< GA_CACHE_LINE aligned slot array. */
+};
+
+GAFitnessCache *ga_fitness_cache_create(size_t slots)
+{
+    if (slots == 0 || slots > ((size_t)1 << 40))
+        return NULL;
+    size_t n = 1;
+    while (n < slots)
+        n <<= 1;
+
+    GAFitnessCache *cache = (GAFitnessCache *)malloc(sizeof(GAFitnessCache));
+    if (!cache)
+        return NULL;
+    size_t bytes = n * sizeof(FitnessSlot);
+    bytes = (bytes + GA_CACHE_LINE - 1) & ~(size_t)(GA_CACHE_LINE - 1);
+    cache->slots = (FitnessSlot *)aligned_alloc(GA_CACHE_LINE, bytes);
+    if (!cache->slots) {
+        free(cache);
+        return NULL;
+    }
+    cache->mask = n - 1;
+    ga_fitness_cache_clear(cache);
+    return cache;
+}
+
+void ga_fitness_cache_destroy(GAFitnessCache *cache)
+{
+    if (!cache)
+        return;
+    free(cache->slots);
+    free(cache);
+}
+
+void ga_fitness_cache_clear(GAFitnessCache *cache)
+{
+    if (!cache)
+        return;
+    for (size_t i = 0; i <= cache->mask; i++) {
+        atomic_init(&cache->slots[i].seq, 0u);
+        atomic_init(&cache->slots[i].key, 0u);
+        atomic_init(&cache->slots[i].check, 0u);
+        atomic_init(&cache->slots[i].bits, 0u);
+    }
+}
+
+int ga_fitness_cache_lookup(const GAFitnessCache *cache, const GAFitnessKey *key,
+                            double *fitness)
+{
+    if (!cache || !key || !fitness)
+        return 0;
+    FitnessSlot *s = &cache->slots[key->hash & cache->mask];
+
+    unsigned seq = atomic_load_explicit(&s->seq, memory_order_acquire);
+    if (seq == 0 || (seq & 1u))
+        return 0;
+    uint64_t k     = atomic_load_explicit(&s->key, memory_order_relaxed);
+    uint64_t check = atomic_load_explicit(&s->check, memory_order_relaxed);
+    uint64_t bits  = atomic_load_explicit(&s->bits, memory_order_relaxed);
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&s->seq, memory_order_relaxed) != seq
+        || k != key->hash || check != key->check)
+        return 0;
+
+    memcpy(fitness, &bits, sizeof(bits));
+    return 1;
+}
+
+void ga_fitness_cache_store(GAFitnessCache *cache, const GAFitnessKey *key, double fitness)
+{
+    if (!cache || !key)
+        return;
+    FitnessSlot *s = &cache->slots[key->hash & cache->mask];
+
+    unsigned seq = atomic_load_explicit(&s->seq, memory_order_relaxed);
+    if ((seq & 1u)
+        || !atomic_compare_exchange_strong_explicit(&s->seq, &seq, seq + 1u,
+                                                    memory_order_relaxed, memory_order_relaxed))
+        return;
+    atomic_thread_fence(memory_order_release);
+
+    uint64_t bits;
+    memcpy(&bits, &fitness, sizeof(bits));
+    atomic_store_explicit(&s->key, key->hash, memory_order_relaxed);
+    atomic_store_explicit(&s->check, key->check, memory_order_relaxed);
+    atomic_store_explicit(&s->bits, bits, memory_order_relaxed);
+    // Skip 0 on wrap-around: it marks never-written slots
+    unsigned next = seq + 2u;
+    atomic_store_explicit(&s->seq, next ? next : 2u, memory_order_release);
+}
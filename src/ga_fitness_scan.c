@@ -0,0 +1,86 @@
+/**
+ * @file ga_fitness_scan.c
+ * @brief Argmin / argmax over fitness arrays (see ga_fitness_scan.h).
+ *
+ * The SSE2 loops keep, in each of the two lanes, the extreme value seen so far and its
+ * index (as a double, exact below 2^53). A lane only moves on a strict improvement, so
+ * it holds the first index of its own extreme; the final reduction prefers the lower
+ * index on ties, which gives the same answer as the scalar loop.
+ */
+
+#include "../includes/genetic_algorithm/ga_fitness_scan.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+  #include <emmintrin.h>
+  #define GA_FITNESS_SCAN_SSE2 1
+#endif
+
+/**
+ * @brief Scalar search of fit[start..end]; @p want_max selects argmax over argmin.
+ */
+static int scan_scalar(const double *fit, int start, int end, int want_max)
+{
+    int best = start;
+    for (int i = start + 1; i <= end; i++) {
+        if (want_max ? fit[i] > fit[best] : fit[i] < fit[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+#ifdef GA_FITNESS_SCAN_SSE2
+/**
+ * @brief SSE2 search of fit[start..end], two slots per step, scalar tail.
+ */
+static int scan_sse2(const double *fit, int start, int end, int want_max)
+{
+    int n = end - start + 1;
+    if (n < 4) return scan_scalar(fit, start, end, want_max);
+
+    __m128d val  = _mm_loadu_pd(fit + start);
+    __m128d idx  = _mm_set_pd((double)(start + 1), (double)start);
+    __m128d cur  = idx;
+    __m128d step = _mm_set1_pd(2.0);
+    int i = start + 2;
+    for (; i + 1 <= end; i += 2) {
+        cur = _mm_add_pd(cur, step);
+        __m128d v    = _mm_loadu_pd(fit + i);
+        __m128d take = want_max ? _mm_cmpgt_pd(v, val) : _mm_cmplt_pd(v, val);
+        val = _mm_or_pd(_mm_and_pd(take, v),   _mm_andnot_pd(take, val));
+        idx = _mm_or_pd(_mm_and_pd(take, cur), _mm_andnot_pd(take, idx));
+    }
+
+    double vals[2], idxs[2];
+    _mm_storeu_pd(vals, val);
+    _mm_storeu_pd(idxs, idx);
+    int lane = (want_max ? vals[1] > vals[0] : vals[1] < vals[0])
+            || (vals[1] == vals[0] && idxs[1] < idxs[0]);
+    int best = (int)idxs[lane];
+
+    for (; i <= end; i++) {
+        if (want_max ? fit[i] > fit[best] : fit[i] < fit[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+#endif
+
+int ga_fitness_argmin(const double *fit, int start, int end)
+{
+#ifdef GA_FITNESS_SCAN_SSE2
+    return scan_sse2(fit, start, end, 0);
+#else
+    return scan_scalar(fit, start, end, 0);
+#endif
+}
+
+int ga_fitness_argmax(const double *fit, int start, int end)
+{
+#ifdef GA_FITNESS_SCAN_SSE2
+    return scan_sse2(fit, start, end, 1);
+#else
+    return scan_scalar(fit, start, end, 1);
+#endif
+}
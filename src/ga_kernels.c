@@ -0,0 +1,216 @@
+/**
+ * @file ga_kernels.c
+ * @brief Scalar reference kernels and runtime selection of the SIMD variants.
+ *
+ * The scalar kernels define the exact results every SIMD variant must reproduce.
+ * ga_kernels_select() fills the dispatch table from SysCapabilities; each entry is
+ * chosen independently, so a missing variant simply falls back to the next best one.
+ * Before a SIMD variant is accepted it is run against the scalar kernel on
+ * pseudo-random data and rejected unless the results are identical.
+ */
+
+#include "../includes/software_rendering/ga_kernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Exact floor(t / 255) for 0 <= t <= 65534, without a division.
+ */
+static inline Uint32 div255(Uint32 t)
+{
+    return (t + 1 + (t >> 8)) >> 8;
+}
+
+/**
+ * @brief Scalar span blend: (src * a + dst * (255 - a)) / 255 per channel.
+ */
+void ga_blend_span_scalar(Uint32 *px, int n, const BlendColor *bc)
+{
+    for (int i = 0; i < n; i++) {
+        Uint32 d = px[i];
+        Uint32 r = div255(bc->pr + ((d >> 16) & 0xFF) * bc->inv_a);
+        Uint32 g = div255(bc->pg + ((d >> 8) & 0xFF) * bc->inv_a);
+        Uint32 b = div255(bc->pb + (d & 0xFF) * bc->inv_a);
+        px[i] = 0xFF000000u | (r << 16) | (g << 8) | b;
+    }
+}
+
+/**
+ * @brief Scalar sum of squared RGB differences.
+ */
+Uint64 ga_sse_span_scalar(const Uint32 *cand, const Uint32 *ref, int n)
+{
+    Uint64 err = 0;
+    for (int i = 0; i < n; i++) {
+        int dr = (int)((cand[i] >> 16) & 0xFF) - (int)((ref[i] >> 16) & 0xFF);
+        int dg = (int)((cand[i] >> 8) & 0xFF) - (int)((ref[i] >> 8) & 0xFF);
+        int db = (int)(cand[i] & 0xFF) - (int)(ref[i] & 0xFF);
+        err += (Uint64)(dr * dr + dg * dg + db * db);
+    }
+    return err;
+}
+
+/** @brief Active dispatch table; scalar until ga_kernels_select() is called. */
+static GAKernels g_kernels = {
+    ga_blend_span_scalar,
+    ga_sse_span_scalar,
+    "scalar",
+    "scalar"
+};
+
+const GAKernels *ga_kernels(void)
+{
+    return &g_kernels;
+}
+
+#ifdef GA_KERNELS_X86
+/** @brief Pixels in the self-check buffers (covers several SIMD bodies plus tails). */
+#define SELFCHECK_PIXELS 203
+
+/** @brief Start offsets checked: every pixel position within a 64-byte line. */
+#define SELFCHECK_OFFSETS 16
+
+/** @brief Short spans 0..SELFCHECK_SHORT are checked at every offset (head/tail-only paths). */
+#define SELFCHECK_SHORT 17
+
+/**
+ * @brief Small deterministic generator for the self-check data.
+ */
+static Uint32 selfcheck_next(Uint32 *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state;
+}
+
+/**
+ * @brief Checks a blend kernel against ga_blend_span_scalar() for equality.
+ *
+ * At every start offset within a cache line (the buffers are line aligned), every
+ * short length 0..SELFCHECK_SHORT is exercised, so spans handled by the masked head
+ * and tail code alone are covered, followed by a long span crossing several SIMD bodies.
+ *
+ * @return Non-zero if all outputs are bit-identical.
+ */
+static int blend_span_matches_scalar(GABlendSpanFunc f)
+{
+    _Alignas(64) Uint32 src[SELFCHECK_PIXELS];
+    _Alignas(64) Uint32 ref[SELFCHECK_PIXELS];
+    _Alignas(64) Uint32 out[SELFCHECK_PIXELS];
+    Uint32 state = 0x9E3779B9u;
+
+    for (int i = 0; i < SELFCHECK_PIXELS; i++) src[i] = selfcheck_next(&state);
+
+    for (int a = 0; a < 256; a += 51) {
+        Uint32 rnd = selfcheck_next(&state);
+        BlendColor bc = {0};
+        bc.pr = ((rnd >> 24) & 0xFF) * (Uint32)a;
+        bc.pg = ((rnd >> 16) & 0xFF) * (Uint32)a;
+        bc.pb = ((rnd >> 8) & 0xFF) * (Uint32)a;
+        bc.inv_a = 255u - (Uint32)a;
+        bc.argb = 1;
+        for (int off = 0; off < SELFCHECK_OFFSETS; off++) {
+            for (int k = 0; k <= SELFCHECK_SHORT + 1; k++) {
+                /* Lengths 0..SELFCHECK_SHORT, then one long span. */
+                int n = k <= SELFCHECK_SHORT ? k : SELFCHECK_PIXELS - off - (off * 7) % 13;
+                memcpy(ref, src, sizeof(src));
+                memcpy(out, src, sizeof(src));
+                ga_blend_span_scalar(ref + off, n, &bc);
+                f(out + off, n, &bc);
+                if (memcmp(ref, out, sizeof(src)) != 0) return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Checks a squared-error kernel against ga_sse_span_scalar() for equality.
+ *
+ * Every length 0..SELFCHECK_SHORT and sparser longer ones are checked at every start
+ * offset within a cache line. Includes a worst-case run (every channel differing by 255)
+ * long enough to cross the 32-bit flush points of the SIMD accumulators.
+ *
+ * @return Non-zero if all sums are identical.
+ */
+static int sse_span_matches_scalar(GASseSpanFunc f)
+{
+    _Alignas(64) Uint32 a[SELFCHECK_PIXELS];
+    _Alignas(64) Uint32 b[SELFCHECK_PIXELS];
+    Uint32 state = 0x2545F491u;
+
+    for (int i = 0; i < SELFCHECK_PIXELS; i++) {
+        a[i] = selfcheck_next(&state);
+        b[i] = selfcheck_next(&state);
+    }
+    for (int off = 0; off < SELFCHECK_OFFSETS; off++) {
+        for (int n = 0; n + off <= SELFCHECK_PIXELS; n += n < SELFCHECK_SHORT ? 1 : 1 + n / 4) {
+            if (f(a + off, b + off, n) != ga_sse_span_scalar(a + off, b + off, n)) return 0;
+        }
+    }
+
+    {
+        enum { WORST = 1 << 17 };
+        Uint32 *white = malloc(WORST * sizeof(Uint32));
+        Uint32 *black = calloc(WORST, sizeof(Uint32));
+        int ok = 1;
+        if (white && black) {
+            for (int i = 0; i < WORST; i++) white[i] = 0xFFFFFFFFu;
+            ok = f(white, black, WORST - 3) == ga_sse_span_scalar(white, black, WORST - 3);
+        }
+        free(white);
+        free(black);
+        if (!ok) return 0;
+    }
+    return 1;
+}
+#endif /* GA_KERNELS_X86 */
+
+void ga_kernels_select(const SysCapabilities *caps)
+{
+    GAKernels k = { ga_blend_span_scalar, ga_sse_span_scalar, "scalar", "scalar" };
+
+#ifdef GA_KERNELS_X86
+    if (caps) {
+        pthread_mutex_lock((pthread_mutex_t *)&caps->mutex);
+        bool sse4 = caps->sse4;
+        bool avx2 = caps->avx2;
+        bool avx512 = caps->avx512 && caps->avx512bw;
+        pthread_mutex_unlock((pthread_mutex_t *)&caps->mutex);
+
+        /* Lowest to highest ISA: a later variant only replaces an earlier one if it
+           is supported and reproduces the scalar results exactly. */
+        const struct {
+            bool            supported;
+            GABlendSpanFunc blend_span;
+            GASseSpanFunc   sse_span;
+            const char     *name;
+        } variants[] = {
+            { sse4,   ga_blend_span_sse41,  ga_sse_span_sse41,  "sse4.1"   },
+            { avx2,   ga_blend_span_avx2,   ga_sse_span_avx2,   "avx2"     },
+            { avx512, ga_blend_span_avx512, ga_sse_span_avx512, "avx512bw" },
+        };
+        for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); v++) {
+            if (!variants[v].supported) continue;
+            if (blend_span_matches_scalar(variants[v].blend_span)) {
+                k.blend_span = variants[v].blend_span;
+                k.blend_span_name = variants[v].name;
+            } else {
+                fprintf(stderr, "[kernels] %s blend_span differs from scalar, not selected.\n",
+                        variants[v].name);
+            }
+            if (sse_span_matches_scalar(variants[v].sse_span)) {
+                k.sse_span = variants[v].sse_span;
+                k.sse_span_name = variants[v].name;
+            } else {
+                fprintf(stderr, "[kernels] %s sse_span differs from scalar, not selected.\n",
+                        variants[v].name);
+            }
+        }
+    }
+#else
+    (void)caps;
+#endif
+
+    g_kernels = k;
+}
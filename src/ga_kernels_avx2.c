@@ -0,0 +1,166 @@
+/**
+ * @file ga_kernels_avx2.c
+ * @brief AVX2 variants of the renderer kernels (8 pixels per iteration).
+ *
+ * Compiled with AVX2 code generation enabled (see CMakeLists.txt); only called
+ * when ga_kernels_select() found AVX2 on the running CPU.
+ */
+
+#include "../includes/software_rendering/ga_kernels.h"
+
+#ifdef GA_KERNELS_X86
+#include <immintrin.h>
+#include <stdint.h>
+
+/**
+ * @brief Lane mask selecting the 32-bit lanes [first..last) of an AVX2 register.
+ *
+ * @param first First enabled lane (0..8).
+ * @param last One past the last enabled lane (0..8).
+ * @return Mask usable with _mm256_maskload_epi32 / _mm256_maskstore_epi32.
+ */
+static inline __m256i lane_mask(int first, int last)
+{
+    const __m256i idx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i ge_first = _mm256_cmpgt_epi32(idx, _mm256_set1_epi32(first - 1));
+    __m256i lt_last  = _mm256_cmpgt_epi32(_mm256_set1_epi32(last), idx);
+    return _mm256_and_si256(ge_first, lt_last);
+}
+
+/**
+ * @brief Blends 8 ARGB8888 pixels using 16-bit lane arithmetic.
+ *
+ * Channels are widened to 16 bits, blended as d * (255 - a) + src * a (at most 65025,
+ * so no lane overflows) and divided by 255 with the same shift sequence as the
+ * scalar kernel.
+ *
+ * @param d 8 destination pixels.
+ * @param inv 16-bit lanes holding 255 - alpha.
+ * @param pre 16-bit lanes holding the premultiplied source channels (B, G, R, 0 order).
+ * @return 8 blended pixels with alpha forced to 255.
+ */
+static inline __m256i blend8_avx2(__m256i d, __m256i inv, __m256i pre)
+{
+    const __m256i zero  = _mm256_setzero_si256();
+    const __m256i one   = _mm256_set1_epi16(1);
+    const __m256i alpha = _mm256_set1_epi32((int)0xFF000000u);
+
+    __m256i lo = _mm256_unpacklo_epi8(d, zero);
+    __m256i hi = _mm256_unpackhi_epi8(d, zero);
+    lo = _mm256_add_epi16(_mm256_mullo_epi16(lo, inv), pre);
+    hi = _mm256_add_epi16(_mm256_mullo_epi16(hi, inv), pre);
+    lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(lo, one), _mm256_srli_epi16(lo, 8)), 8);
+    hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(hi, one), _mm256_srli_epi16(hi, 8)), 8);
+    return _mm256_or_si256(_mm256_packus_epi16(lo, hi), alpha);
+}
+
+/**
+ * @brief AVX2 span blend.
+ *
+ * The unaligned head (up to the next 32-byte boundary) and the tail of the run are
+ * handled with masked loads/stores on the enclosing aligned block, so every full
+ * iteration uses aligned accesses and no pixel outside the run is touched.
+ */
+void ga_blend_span_avx2(Uint32 *px, int n, const BlendColor *bc)
+{
+    if (n <= 0)
+        return;
+
+    const __m256i inv = _mm256_set1_epi16((short)bc->inv_a);
+    const __m256i pre = _mm256_setr_epi16((short)bc->pb, (short)bc->pg, (short)bc->pr, 0,
+                                          (short)bc->pb, (short)bc->pg, (short)bc->pr, 0,
+                                          (short)bc->pb, (short)bc->pg, (short)bc->pr, 0,
+                                          (short)bc->pb, (short)bc->pg, (short)bc->pr, 0);
+
+    /* Masked head: the lanes of the aligned block containing px that belong to the run. */
+    int head = (int)(((uintptr_t)px >> 2) & 7);
+    if (head) {
+        Uint32 *block = px - head;
+        int last = (head + n < 8) ? head + n : 8;
+        __m256i m = lane_mask(head, last);
+        __m256i d = _mm256_maskload_epi32((const int*)block, m);
+        _mm256_maskstore_epi32((int*)block, m, blend8_avx2(d, inv, pre));
+        int done = last - head;
+        px += done;
+        n  -= done;
+    }
+
+    /* Aligned body. */
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i d = _mm256_load_si256((const __m256i*)(px + i));
+        _mm256_store_si256((__m256i*)(px + i), blend8_avx2(d, inv, pre));
+    }
+
+    /* Masked tail. */
+    if (i < n) {
+        __m256i m = lane_mask(0, n - i);
+        __m256i d = _mm256_maskload_epi32((const int*)(px + i), m);
+        _mm256_maskstore_epi32((int*)(px + i), m, blend8_avx2(d, inv, pre));
+    }
+}
+
+/**
+ * @brief Iterations after which the 32-bit partial sums are flushed to 64 bits.
+ *
+ * Each iteration adds two madd results, each the sum of two squared differences, so at
+ * most 4 * 255^2 to a 32-bit lane; 4096 iterations stay below 2^31.
+ */
+#define AVX2_FLUSH_ITERS 4096
+
+/**
+ * @brief Squared error of 8 pixels, as 8 partial sums in 32-bit lanes.
+ *
+ * Channels are widened to 16 bits and subtracted; madd squares the differences and
+ * adds them pairwise, so the result is exact.
+ */
+static inline __m256i sse8_avx2(__m256i c, __m256i r)
+{
+    const __m256i rgb = _mm256_set1_epi32(0x00FFFFFF);
+    c = _mm256_and_si256(c, rgb);
+    r = _mm256_and_si256(r, rgb);
+    __m256i d_lo = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(c)),
+                                    _mm256_cvtepu8_epi16(_mm256_castsi256_si128(r)));
+    __m256i d_hi = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(c, 1)),
+                                    _mm256_cvtepu8_epi16(_mm256_extracti128_si256(r, 1)));
+    return _mm256_add_epi32(_mm256_madd_epi16(d_lo, d_lo), _mm256_madd_epi16(d_hi, d_hi));
+}
+
+/**
+ * @brief AVX2 sum of squared RGB differences, 8 pixels per iteration.
+ *
+ * Integer-only: 16-bit differences, madd into 32-bit lanes, widened to 64 bits every
+ * AVX2_FLUSH_ITERS iterations. The tail is read with a masked load, so the result is
+ * bit-identical to ga_sse_span_scalar().
+ */
+Uint64 ga_sse_span_avx2(const Uint32 *cand, const Uint32 *ref, int n)
+{
+    __m256i acc64 = _mm256_setzero_si256();
+    int i = 0;
+
+    while (i < n) {
+        __m256i acc32 = _mm256_setzero_si256();
+        int stop = i + 8 * AVX2_FLUSH_ITERS;
+        if (stop > n) stop = n;
+        for (; i + 8 <= stop; i += 8) {
+            __m256i c = _mm256_loadu_si256((const __m256i*)(cand + i));
+            __m256i r = _mm256_loadu_si256((const __m256i*)(ref + i));
+            acc32 = _mm256_add_epi32(acc32, sse8_avx2(c, r));
+        }
+        if (i < stop) {
+            /* Masked tail: disabled lanes read as zero on both sides and add nothing. */
+            __m256i m = lane_mask(0, stop - i);
+            __m256i c = _mm256_maskload_epi32((const int*)(cand + i), m);
+            __m256i r = _mm256_maskload_epi32((const int*)(ref + i), m);
+            acc32 = _mm256_add_epi32(acc32, sse8_avx2(c, r));
+            i = stop;
+        }
+        acc64 = _mm256_add_epi64(acc64, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(acc32)));
+        acc64 = _mm256_add_epi64(acc64, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(acc32, 1)));
+    }
+
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(acc64), _mm256_extracti128_si256(acc64, 1));
+    return (Uint64)_mm_cvtsi128_si64(s) + (Uint64)_mm_extract_epi64(s, 1);
+}
+
+#endif /* GA_KERNELS_X86 */
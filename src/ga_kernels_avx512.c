@@ -0,0 +1,113 @@
+/**
+ * @file ga_kernels_avx512.c
+ * @brief AVX-512 (F + BW) variants of the renderer kernels (16 pixels per iteration).
+ *
+ * Compiled with AVX-512F/BW code generation enabled (see CMakeLists.txt); only called
+ * when ga_kernels_select() found both extensions on the running CPU. Row tails are
+ * handled with mask registers instead of a scalar loop.
+ */
+
+#include "../includes/software_rendering/ga_kernels.h"
+
+#ifdef GA_KERNELS_X86
+#include <immintrin.h>
+
+/**
+ * @brief Mask register enabling the first @p n (0..16) 32-bit lanes.
+ */
+static inline __mmask16 tail_mask16(int n)
+{
+    return (__mmask16)((1u << n) - 1u);
+}
+
+/**
+ * @brief Blends 16 ARGB8888 pixels in 16-bit lanes (same arithmetic as the scalar kernel).
+ */
+static inline __m512i blend16_avx512(__m512i d, __m512i inv, __m512i pre)
+{
+    const __m512i zero  = _mm512_setzero_si512();
+    const __m512i one   = _mm512_set1_epi16(1);
+    const __m512i alpha = _mm512_set1_epi32((int)0xFF000000u);
+
+    __m512i lo = _mm512_unpacklo_epi8(d, zero);
+    __m512i hi = _mm512_unpackhi_epi8(d, zero);
+    lo = _mm512_add_epi16(_mm512_mullo_epi16(lo, inv), pre);
+    hi = _mm512_add_epi16(_mm512_mullo_epi16(hi, inv), pre);
+    lo = _mm512_srli_epi16(_mm512_add_epi16(_mm512_add_epi16(lo, one), _mm512_srli_epi16(lo, 8)), 8);
+    hi = _mm512_srli_epi16(_mm512_add_epi16(_mm512_add_epi16(hi, one), _mm512_srli_epi16(hi, 8)), 8);
+    return _mm512_or_si512(_mm512_packus_epi16(lo, hi), alpha);
+}
+
+void ga_blend_span_avx512(Uint32 *px, int n, const BlendColor *bc)
+{
+    const __m512i inv = _mm512_set1_epi16((short)bc->inv_a);
+    const __m512i pre = _mm512_set1_epi64((long long)(((Uint64)bc->pr << 32) |
+                                                      ((Uint64)bc->pg << 16) |
+                                                      (Uint64)bc->pb));
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i d = _mm512_loadu_si512((const void*)(px + i));
+        _mm512_storeu_si512((void*)(px + i), blend16_avx512(d, inv, pre));
+    }
+    if (i < n) {
+        __mmask16 m = tail_mask16(n - i);
+        __m512i d = _mm512_maskz_loadu_epi32(m, px + i);
+        _mm512_mask_storeu_epi32(px + i, m, blend16_avx512(d, inv, pre));
+    }
+}
+
+/**
+ * @brief Iterations after which the 32-bit partial sums are flushed to 64 bits.
+ *
+ * Each iteration adds at most 2 * 2 * 255^2 to a 32-bit lane, so 4096 iterations
+ * stay far below 2^31.
+ */
+#define AVX512_FLUSH_ITERS 4096
+
+/**
+ * @brief Squared error of 16 pixels, as 16 partial sums in 32-bit lanes.
+ *
+ * Channels are widened to 16 bits, subtracted, and squared-and-paired with madd, so
+ * the result is exact.
+ */
+static inline __m512i sse16_avx512(__m512i c, __m512i r)
+{
+    const __m512i rgb = _mm512_set1_epi32(0x00FFFFFF);
+    c = _mm512_and_si512(c, rgb);
+    r = _mm512_and_si512(r, rgb);
+    __m512i d_lo = _mm512_sub_epi16(_mm512_cvtepu8_epi16(_mm512_castsi512_si256(c)),
+                                    _mm512_cvtepu8_epi16(_mm512_castsi512_si256(r)));
+    __m512i d_hi = _mm512_sub_epi16(_mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(c, 1)),
+                                    _mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(r, 1)));
+    return _mm512_add_epi32(_mm512_madd_epi16(d_lo, d_lo), _mm512_madd_epi16(d_hi, d_hi));
+}
+
+Uint64 ga_sse_span_avx512(const Uint32 *cand, const Uint32 *ref, int n)
+{
+    __m512i acc64 = _mm512_setzero_si512();
+    int i = 0;
+
+    while (i < n) {
+        __m512i acc32 = _mm512_setzero_si512();
+        int stop = i + 16 * AVX512_FLUSH_ITERS;
+        if (stop > n) stop = n;
+        for (; i + 16 <= stop; i += 16) {
+            __m512i c = _mm512_loadu_si512((const void*)(cand + i));
+            __m512i r = _mm512_loadu_si512((const void*)(ref + i));
+            acc32 = _mm512_add_epi32(acc32, sse16_avx512(c, r));
+        }
+        if (i < stop) {
+            /* Masked tail: disabled lanes load as zero on both sides and add nothing. */
+            __mmask16 m = tail_mask16(stop - i);
+            __m512i c = _mm512_maskz_loadu_epi32(m, cand + i);
+            __m512i r = _mm512_maskz_loadu_epi32(m, ref + i);
+            acc32 = _mm512_add_epi32(acc32, sse16_avx512(c, r));
+            i = stop;
+        }
+        acc64 = _mm512_add_epi64(acc64, _mm512_cvtepu32_epi64(_mm512_castsi512_si256(acc32)));
+        acc64 = _mm512_add_epi64(acc64, _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(acc32, 1)));
+    }
+    return (Uint64)_mm512_reduce_add_epi64(acc64);
+}
+
+#endif /* GA_KERNELS_X86 */
@@ -0,0 +1,74 @@
+/**
+ * @file ga_mailbox.c
+ * @brief Lock-free SPSC ring buffer of pointers (see ga_mailbox.h).
+ *
+ * head and tail count items ever popped and pushed; their difference is the number of
+ * queued items and they index the slot array modulo its power-of-two size. The producer
+ * publishes a slot with a release store of tail, the consumer frees it with a release
+ * store of head, and each side acquires the other's index before touching a slot.
+ */
+
+#include "../includes/genetic_algorithm/ga_mailbox.h"
+#include "../includes/genetic_algorithm/genetic_art.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+struct GAMailbox {
+    _Alignas(GA_CACHE_LINE) atomic_size_t head; /**< Items popped (written by the consumer). */
+    _Alignas(GA_CACHE_LINE) atomic_size_t tail; /**< Items pushed (written by the producer). */
+    _Alignas(GA_CACHE_LINE) size_t mask;        /**< Slot count - 1. */
+    void **slots;                               /**< Ring of queued items. */
+};
+
+GAMailbox *ga_mailbox_create(size_t capacity)
+{
+    if (capacity == 0 || capacity > ((size_t)1 << 30))
+        return NULL;
+    size_t n = 1;
+    while (n < capacity)
+        n <<= 1;
+
+    size_t bytes = (sizeof(GAMailbox) + GA_CACHE_LINE - 1) & ~(size_t)(GA_CACHE_LINE - 1);
+    GAMailbox *box = (GAMailbox *)aligned_alloc(GA_CACHE_LINE, bytes);
+    if (!box)
+        return NULL;
+    box->slots = (void **)calloc(n, sizeof(void *));
+    if (!box->slots) {
+        free(box);
+        return NULL;
+    }
+    box->mask = n - 1;
+    atomic_init(&box->head, 0);
+    atomic_init(&box->tail, 0);
+    return box;
+}
+
+void ga_mailbox_destroy(GAMailbox *box)
+{
+    if (!box)
+        return;
+    free(box->slots);
+    free(box);
+}
+
+int ga_mailbox_push(GAMailbox *box, void *item)
+{
+    size_t tail = atomic_load_explicit(&box->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&box->head, memory_order_acquire);
+    if (tail - head > box->mask)
+        return 0;
+    box->slots[tail & box->mask] = item;
+    atomic_store_explicit(&box->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+void *ga_mailbox_pop(GAMailbox *box)
+{
+    size_t head = atomic_load_explicit(&box->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&box->tail, memory_order_acquire);
+    if (head == tail)
+        return NULL;
+    void *item = box->slots[head & box->mask];
+    atomic_store_explicit(&box->head, head + 1, memory_order_release);
+    return item;
+}
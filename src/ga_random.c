@@ -0,0 +1,29 @@
+/**
+ * @file ga_random.c
+ * @brief Seeding of the xoshiro256++ streams (see ga_random.h).
+ *
+ * The stream number is scrambled into the seed, then splitmix64 expands the result into
+ * the 256-bit state, as recommended by the xoshiro authors: splitmix64 never yields an
+ * all-zero state and decorrelates neighbouring stream numbers.
+ */
+
+#include "../includes/genetic_algorithm/ga_random.h"
+
+/**
+ * @brief One splitmix64 step: advances @p x and returns the next output.
+ */
+static uint64_t splitmix64(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void ga_random_seed(GARandom *r, uint64_t seed, uint64_t stream)
+{
+    uint64_t mix = stream;
+    uint64_t x = seed ^ splitmix64(&mix);
+    for (int i = 0; i < 4; i++)
+        r->s[i] = splitmix64(&x);
+}
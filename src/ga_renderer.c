@@ -8,13 +8,12 @@
  */
 
  #include "../includes/software_rendering/ga_renderer.h"
+ #include "../includes/software_rendering/ga_kernels.h"
  #include <stdlib.h>
  #include <string.h>
  #include <math.h>
  #include <stdio.h>
- #ifdef __AVX2__
- #include <immintrin.h>
- #endif
+ #include <pthread.h>
  
  /**
   * @brief Clamps integer v within [lo..hi].
@@ -38,6 +37,7 @@
   *
   * This function blends the source color `src` over the destination color `dst` using alpha blending.
   * The resulting alpha is forced to 255 to maintain opaque final pixels.
+  * Generic (any SDL pixel format) path; ARGB8888 canvases use the kernels of ga_kernels.h.
   *
   * @param dst Destination color ARGB.
   * @param src Source color ARGB.
@@ -63,67 +63,405 @@
      return SDL_MapRGBA(fmt, rr, rg, rb, 255);
  }
  
+ /**
+  * @brief Prepares the blend constants of a gene for a given canvas format.
+  *
+  * @param g Gene providing the RGBA color.
+  * @param fmt Canvas pixel format.
+  * @return Blend constants for blend_span().
+  */
+ static inline BlendColor make_blend_color(const Gene *g, const SDL_PixelFormat *fmt)
+ {
+     BlendColor bc;
+     bc.col   = SDL_MapRGBA(fmt, g->r, g->g, g->b, g->a);
+     bc.pr    = (Uint32)g->r * g->a;
+     bc.pg    = (Uint32)g->g * g->a;
+     bc.pb    = (Uint32)g->b * g->a;
+     bc.inv_a = 255u - g->a;
+     bc.argb  = (fmt->format == SDL_PIXELFORMAT_ARGB8888);
+     return bc;
+ }
+ 
+ /**
+  * @brief Blends a horizontal run of pixels, using the dispatched integer kernel for ARGB8888.
+  *
+  * @param px First pixel of the run.
+  * @param n Number of pixels (nothing happens if n <= 0).
+  * @param bc Blend constants of the shape.
+  * @param fmt Canvas pixel format (used by the generic fallback only).
+  */
+ static inline void blend_span(Uint32 *px, int n, const BlendColor *bc, const SDL_PixelFormat *fmt)
+ {
+     if (bc->argb) {
+         if (n > 0)
+             ga_kernels()->blend_span(px, n, bc);
+         return;
+     }
+     for (int i = 0; i < n; i++) {
+         px[i] = alpha_blend(px[i], bc->col, fmt);
+     }
+ }
+ 
+ /**
+  * @brief Axis-aligned clip rectangle in canvas pixels, half-open: [x0..x1) x [y0..y1).
+  *
+  * Every drawing primitive only touches pixels inside the clip rectangle, so that a
+  * sub-region of a canvas can be recomposited without disturbing the rest of it.
+  */
+ typedef struct {
+     int x0; /**< Left edge (inclusive). */
+     int y0; /**< Top edge (inclusive). */
+     int x1; /**< Right edge (exclusive). */
+     int y1; /**< Bottom edge (exclusive). */
+ } ClipRect;
+ 
+ /**
+  * @brief Tests whether a clip rectangle contains no pixel.
+  *
+  * @param r Rectangle to test.
+  * @return Non-zero if @p r is empty.
+  */
+ static inline int clip_empty(const ClipRect *r)
+ {
+     return r->x0 >= r->x1 || r->y0 >= r->y1;
+ }
+ 
+ /**
+  * @brief Grows @p acc so that it also covers @p r (empty rectangles are ignored).
+  *
+  * @param acc Accumulated rectangle (may be empty).
+  * @param r   Rectangle to merge in.
+  */
+ static inline void clip_union(ClipRect *acc, const ClipRect *r)
+ {
+     if (clip_empty(r))
+         return;
+     if (clip_empty(acc)) {
+         *acc = *r;
+         return;
+     }
+     if (r->x0 < acc->x0) acc->x0 = r->x0;
+     if (r->y0 < acc->y0) acc->y0 = r->y0;
+     if (r->x1 > acc->x1) acc->x1 = r->x1;
+     if (r->y1 > acc->y1) acc->y1 = r->y1;
+ }
+ 
+ /**
+  * @brief Tells whether canvas row @p y belongs to the row sample set.
+  *
+  * Rows are stratified in bands of 2^row_shift rows and exactly one row is kept per
+  * band; its offset in the band follows the golden-ratio (Kronecker) sequence of the
+  * band index, so the kept rows do not line up with periodic image structure.
+  *
+  * @param y Canvas row.
+  * @param row_shift Log2 of the band height (0 keeps every row).
+  * @return Non-zero if row @p y is sampled.
+  */
+ static inline int row_sampled(int y, int row_shift)
+ {
+     if (row_shift <= 0)
+         return 1;
+     Uint32 band = (Uint32)y >> row_shift;
+     Uint32 pick = (band * 0x9E3779B9u) >> (32 - row_shift);
+     return ((Uint32)y & ((1u << row_shift) - 1u)) == pick;
+ }
+ 
+ /**
+  * @brief Counts the sampled rows in [0..height).
+  *
+  * @param height Canvas height.
+  * @param row_shift Log2 of the band height (see row_sampled()).
+  * @return Number of sampled rows.
+  */
+ static int sampled_row_count(int height, int row_shift)
+ {
+     int n = 0;
+     for (int y = 0; y < height; y++) {
+         n += row_sampled(y, row_shift);
+     }
+     return n;
+ }
+ 
+ /**
+  * @brief Coverage statistics of a shape, gathered instead of drawing it.
+  *
+  * Used by the color solver: every span the shape covers adds its pixel count, the
+  * reference RGB sums (from a summed-area table) and the RGB sums of the canvas beneath.
+  */
+ typedef struct {
+     const Uint32 *sat;   /**< Summed-area table of the reference level (RGB triples). */
+     int      sat_row;    /**< Entries per table row (level width + 1). */
+     Uint64   count;      /**< Covered pixels. */
+     Uint64   ref[3];     /**< Reference R, G, B summed over the covered pixels. */
+     Uint64   under[3];   /**< Canvas R, G, B summed over the covered pixels. */
+ } ColorSums;
+ 
+ /**
+  * @brief Destination of the drawing primitives: a canvas and the region that may be written.
+  *
+  * Canvas pixel (x, y) is stored at px[y * row_len + x].
+  */
+ typedef struct {
+     Uint32  *px;        /**< Canvas pixels. */
+     int      row_len;   /**< Pixels per canvas row. */
+     ClipRect clip;      /**< Canvas region that may be written. */
+     int      row_shift; /**< Row sampling (see row_sampled(); 0 draws every row). */
+     ColorSums *sums;    /**< If set, spans are accumulated into it and the canvas is only read. */
+ } RenderTarget;
+ 
+ /**
+  * @brief Returns the storage address of canvas pixel (x, y) of a render target.
+  */
+ static inline Uint32 *target_pixel(const RenderTarget *t, int x, int y)
+ {
+     return t->px + (size_t)y * t->row_len + x;
+ }
+ 
+ /**
+  * @brief Adds the span [x..x+n) of row y to the coverage statistics of a render target.
+  *
+  * Table sums wrap modulo 2^32; the four-corner difference of a span is still exact,
+  * since a span sum never exceeds 255 * width.
+  */
+ static void accumulate_span(const RenderTarget *t, int x, int y, int n)
+ {
+     if (n <= 0)
+         return;
+     ColorSums *s = t->sums;
+     const Uint32 *px = target_pixel(t, x, y);
+     Uint64 r = 0, g = 0, b = 0;
+     for (int i = 0; i < n; i++) {
+         r += (px[i] >> 16) & 0xFF;
+         g += (px[i] >> 8) & 0xFF;
+         b += px[i] & 0xFF;
+     }
+     s->under[0] += r;
+     s->under[1] += g;
+     s->under[2] += b;
+ 
+     const Uint32 *top = s->sat + ((size_t)y * s->sat_row + x) * 3;
+     const Uint32 *bot = top + (size_t)s->sat_row * 3;
+     size_t end = (size_t)n * 3;
+     for (int ch = 0; ch < 3; ch++) {
+         s->ref[ch] += (Uint32)(bot[end + ch] - bot[ch] - top[end + ch] + top[ch]);
+     }
+     s->count += (Uint64)n;
+ }
+ 
+ /**
+  * @brief Outputs one span of a shape: blended into the target, or accumulated (see ColorSums).
+  */
+ static inline void emit_span(const RenderTarget *t, int x, int y, int n,
+                              const BlendColor *bc, const SDL_PixelFormat *fmt)
+ {
+     if (t->sums) {
+         accumulate_span(t, x, y, n);
+         return;
+     }
+     blend_span(target_pixel(t, x, y), n, bc, fmt);
+ }
+ 
+ /**
+  * @brief Largest radius served by the circle span table.
+  *
+  * random_gene() and mutate_gene() draw radii in [1..50], and pyramid levels only shrink
+  * them, so every evolved circle is covered; larger radii fall back to sqrtf(). May be
+  * overridden at build time (0 sends every circle through sqrtf(), see bench/).
+  */
+ #ifndef CIRCLE_LUT_MAX_RADIUS
+ #define CIRCLE_LUT_MAX_RADIUS 50
+ #endif
+ 
+ /**
+  * @brief Half-widths of circle rows: entry r * (r + 1) / 2 + |dy| is floor(sqrt(r^2 - dy^2)).
+  *
+  * Stored as a triangle (row r has r + 1 entries), 1326 bytes in total.
+  */
+ static Uint8 g_circle_spans[(CIRCLE_LUT_MAX_RADIUS + 1) * (CIRCLE_LUT_MAX_RADIUS + 2) / 2];
+ static pthread_once_t g_circle_spans_once = PTHREAD_ONCE_INIT;
+ 
+ /**
+  * @brief Fills g_circle_spans with exactly the values draw_circle() used to compute per row.
+  */
+ static void build_circle_spans(void)
+ {
+     for (int r = 0; r <= CIRCLE_LUT_MAX_RADIUS; r++) {
+         Uint8 *row = g_circle_spans + r * (r + 1) / 2;
+         for (int dy = 0; dy <= r; dy++) {
+             row[dy] = (Uint8)(int)sqrtf((float)(r * r - dy * dy));
+         }
+     }
+ }
+ 
+ /**
+  * @brief Returns the smallest sampled row >= @p y (see row_sampled()).
+  *
+  * Lets row loops jump from one sampled row to the next instead of testing every row.
+  */
+ static inline int next_sampled_row(int y, int row_shift)
+ {
+     if (row_shift <= 0)
+         return y;
+     Uint32 band = (Uint32)y >> row_shift;
+     int first = (int)((band << row_shift) + ((band * 0x9E3779B9u) >> (32 - row_shift)));
+     if (first >= y)
+         return first;
+     band++;
+     return (int)((band << row_shift) + ((band * 0x9E3779B9u) >> (32 - row_shift)));
+ }
+ 
  /**
   * @brief Draws a filled circle via alpha blending into pixel buffer.
   *
   * This function draws a filled circle with the specified center, radius, and color into the pixel buffer.
   * It uses alpha blending to combine the circle's color with the existing pixel colors.
+  * Only pixels inside the target's clip rectangle and on sampled rows are written.
+  *
+  * Row half-widths come from a table built once (radius <= CIRCLE_LUT_MAX_RADIUS). The
+  * row range is clipped before the loop, which visits sampled rows only, and circles
+  * lying horizontally inside the clip rectangle skip the per-row clamping.
   *
-  * @param px Pointer to the pixel buffer (ARGB).
-  * @param pitch The row size in bytes of the buffer.
+  * @param t Render target.
   * @param fmt SDL_PixelFormat pointer.
   * @param cx Center x-coordinate.
   * @param cy Center y-coordinate.
   * @param r Circle radius.
-  * @param col ARGB color to fill.
-  * @param width Intended image width in pixels.
-  * @param height Image height in pixels.
+  * @param bc Blend constants of the fill color.
   */
- static void draw_circle(Uint32 *px, int pitch, const SDL_PixelFormat *fmt,
-                          int cx, int cy, int r, Uint32 col,
-                          int width, int height)
+ static void draw_circle(const RenderTarget *t, const SDL_PixelFormat *fmt,
+                          int cx, int cy, int r, const BlendColor *bc)
  {
-     if (!px || !fmt || r <= 0 || width <= 0 || height <= 0)
+     const ClipRect *clip = &t->clip;
+     if (!t->px || !fmt || r <= 0 || clip_empty(clip))
          return;
  
-     int row_len = pitch / 4; /* Number of pixels per row */
-     int r2 = r * r;
+     int y_first = (clip->y0 > cy - r) ? clip->y0 : cy - r;
+     int y_last  = (clip->y1 - 1 < cy + r) ? clip->y1 - 1 : cy + r;
+     if (y_first > y_last || cx + r < clip->x0 || cx - r >= clip->x1)
+         return;
  
-     for (int dy = -r; dy <= r; dy++) {
-         int y = cy + dy;
-         if (y < 0 || y >= height)
-             continue;
+     if (r > CIRCLE_LUT_MAX_RADIUS) {
+         int r2 = r * r;
+         for (int y = next_sampled_row(y_first, t->row_shift); y <= y_last;
+              y = next_sampled_row(y + 1, t->row_shift)) {
+             int dy = y - cy;
+             int dx_max = (int)sqrtf((float)(r2 - dy * dy));
+             int xa = clampi(cx - dx_max, clip->x0, clip->x1);
+             int xb = clampi(cx + dx_max + 1, clip->x0, clip->x1);
+             emit_span(t, xa, y, xb - xa, bc, fmt);
+         }
+         return;
+     }
  
-         int dx_max = (int)sqrtf((float)(r2 - dy * dy));
-         for (int dx = -dx_max; dx <= dx_max; dx++) {
-             int x = cx + dx;
-             if (x < 0 || x >= row_len)
-                 continue;
+     pthread_once(&g_circle_spans_once, build_circle_spans);
+     const Uint8 *spans = g_circle_spans + r * (r + 1) / 2;
  
-             int idx = y * row_len + x;
-             px[idx] = alpha_blend(px[idx], col, fmt);
+     if (cx - r >= clip->x0 && cx + r < clip->x1) {
+         // Every span is inside the clip rectangle horizontally
+         for (int y = next_sampled_row(y_first, t->row_shift); y <= y_last;
+              y = next_sampled_row(y + 1, t->row_shift)) {
+             int dy = y - cy;
+             int dx_max = spans[dy < 0 ? -dy : dy];
+             emit_span(t, cx - dx_max, y, 2 * dx_max + 1, bc, fmt);
          }
+         return;
+     }
+ 
+     for (int y = next_sampled_row(y_first, t->row_shift); y <= y_last;
+          y = next_sampled_row(y + 1, t->row_shift)) {
+         int dy = y - cy;
+         int dx_max = spans[dy < 0 ? -dy : dy];
+         int xa = clampi(cx - dx_max, clip->x0, clip->x1);
+         int xb = clampi(cx + dx_max + 1, clip->x0, clip->x1);
+         emit_span(t, xa, y, xb - xa, bc, fmt);
      }
  }
  
  /**
-  * @brief Linear interpolation helper for triangle edges.
+  * @brief Edge function of a triangle edge, evaluated at pixel centers.
   *
-  * This function performs linear interpolation to find the x-coordinate on the edge
-  * between two points (xa, ya) and (xb, yb) at a given y-coordinate.
+  * F(x, y) = dx * x + dy * y + c is twice the edge function at the center
+  * (x + 0.5, y + 0.5) of pixel (x, y), minus one on edges that do not own their
+  * boundary. A pixel is covered iff F >= 0 for all three edges.
+  */
+ typedef struct {
+     Sint64 dx; /**< Increment per pixel to the right. */
+     Sint64 dy; /**< Increment per pixel down. */
+     Sint64 c;  /**< Value at pixel (0, 0). */
+ } TriEdge;
+ 
+ /**
+  * @brief Sets up the edge function of edge a -> b, for a triangle with positive area.
   *
-  * @param y Current y coordinate.
-  * @param xa First edge x.
-  * @param ya First edge y.
-  * @param xb Second edge x.
-  * @param yb Second edge y.
-  * @return Interpolated x at line y.
+  * The top-left fill rule decides pixels whose center lies exactly on the edge: they
+  * belong to the triangle only if the edge is a left edge (interior towards +x) or a
+  * horizontal top edge (interior towards +y). Triangles sharing an edge therefore
+  * never both draw, nor both miss, a pixel on it.
+  */
+ static inline TriEdge tri_edge(int ax, int ay, int bx, int by)
+ {
+     Sint64 A = (Sint64)ay - by;
+     Sint64 B = (Sint64)bx - ax;
+     Sint64 C = (Sint64)ax * by - (Sint64)ay * bx;
+     int owns_boundary = A > 0 || (A == 0 && B > 0);
+     TriEdge e = { 2 * A, 2 * B, A + B + 2 * C - (owns_boundary ? 0 : 1) };
+     return e;
+ }
+ 
+ /**
+  * @brief floor(a / b) for b > 0.
+  */
+ static inline Sint64 floor_div(Sint64 a, Sint64 b)
+ {
+     Sint64 q = a / b;
+     return (a % b != 0 && a < 0) ? q - 1 : q;
+ }
+ 
+ /**
+  * @brief Row-by-row bound x(y) of one non-horizontal edge, stepped without divisions.
+  *
+  * For dx > 0 the edge admits x >= ceil(-(dy * y + c) / dx) (a left bound); for dx < 0
+  * it admits x <= floor((dy * y + c) / -dx) (a right bound). Both are floor(N / d) of a
+  * numerator N that changes by a constant from one row to the next, so the quotient
+  * and remainder are advanced like a Bresenham DDA.
+  */
+ typedef struct {
+     Sint64 q;  /**< Current bound (quotient). */
+     Sint64 r;  /**< Remainder, in [0..d). */
+     Sint64 d;  /**< |dx|. */
+     Sint64 dq; /**< Quotient step per row. */
+     Sint64 dr; /**< Remainder step per row, in [0..d). */
+ } TriEdgeStep;
+ 
+ static inline TriEdgeStep tri_edge_step(const TriEdge *e, int y)
+ {
+     TriEdgeStep s;
+     Sint64 g    = e->dy * y + e->c;
+     s.d         = e->dx > 0 ? e->dx : -e->dx;
+     Sint64 n    = e->dx > 0 ? -g + s.d - 1 : g;
+     Sint64 step = e->dx > 0 ? -e->dy : e->dy;
+     s.q  = floor_div(n, s.d);
+     s.r  = n - s.q * s.d;
+     s.dq = floor_div(step, s.d);
+     s.dr = step - s.dq * s.d;
+     return s;
+ }
+ 
+ /**
+  * @brief Bound that never restricts the span (stands in for a missing edge).
   */
- static inline float edge(int y, int xa, int ya, int xb, int yb)
+ static inline TriEdgeStep tri_edge_step_const(Sint64 q)
+ {
+     TriEdgeStep s = { q, 0, 1, 0, 0 };
+     return s;
+ }
+ 
+ static inline void tri_edge_advance(TriEdgeStep *s)
  {
-     if (yb == ya)
-         return (float)xa;
-     return xa + (xb - xa) * ((float)(y - ya) / (float)(yb - ya));
+     s->r += s->dr;
+     Sint64 carry = s->r >= s->d;
+     s->q += s->dq + carry;
+     s->r -= carry ? s->d : 0;
  }
  
  /**
@@ -131,9 +469,17 @@
   *
   * This function draws a filled triangle with the specified vertices and color into the pixel buffer.
   * It uses alpha blending to combine the triangle's color with the existing pixel colors.
+  * Only the pixels inside the target's clip rectangle and on sampled rows are written.
   *
-  * @param px Pointer to the pixel buffer (ARGB).
-  * @param pitch Row size in bytes of the buffer.
+  * Half-space rasterizer: a pixel is drawn iff its center lies inside the triangle
+  * (integer edge functions, top-left rule on the boundary), so vertices are never
+  * moved and the result does not depend on the clip rectangle. The covered pixels of
+  * a row form one interval, whose ends are the tightest bounds of the three edges;
+  * those bounds are stepped from row to row in exact integer arithmetic and the
+  * interval, clipped, is blended as one span. Degenerate (zero-area) triangles cover
+  * no pixel.
+  *
+  * @param t Render target.
   * @param fmt SDL_PixelFormat pointer.
   * @param x1 X of vertex1.
   * @param y1 Y of vertex1.
@@ -141,53 +487,235 @@
   * @param y2 Y of vertex2.
   * @param x3 X of vertex3.
   * @param y3 Y of vertex3.
-  * @param col ARGB color to fill.
-  * @param width Intended image width in pixels.
-  * @param height Image height in pixels.
+  * @param bc Blend constants of the fill color.
   */
- static void draw_triangle(Uint32 *px, int pitch, const SDL_PixelFormat *fmt,
+ static void draw_triangle(const RenderTarget *t, const SDL_PixelFormat *fmt,
                             int x1, int y1, int x2, int y2, int x3, int y3,
-                            Uint32 col, int width, int height)
+                            const BlendColor *bc)
  {
-     if (!px || !fmt || width <= 0 || height <= 0)
+     const ClipRect *clip = &t->clip;
+     if (!t->px || !fmt || clip_empty(clip))
          return;
  
-     int row_len = pitch / 4;
-     x1 = clampi(x1, 0, row_len - 1);
-     x2 = clampi(x2, 0, row_len - 1);
-     x3 = clampi(x3, 0, row_len - 1);
-     y1 = clampi(y1, 0, height - 1);
-     y2 = clampi(y2, 0, height - 1);
-     y3 = clampi(y3, 0, height - 1);
- 
-     if (y1 > y2) { int tx=x1; x1=x2; x2=tx; int ty=y1; y1=y2; y2=ty; }
-     if (y1 > y3) { int tx=x1; x1=x3; x3=tx; int ty=y1; y1=y3; y3=ty; }
-     if (y2 > y3) { int tx=x2; x2=x3; x3=tx; int ty=y2; y2=y3; y3=ty; }
- 
-     for (int y = y1; y <= y3; y++) {
-         float xa, xb;
-         if (y < y2)
-             xa = edge(y, x1, y1, x2, y2);
-         else
-             xa = edge(y, x2, y2, x3, y3);
- 
-         xb = edge(y, x1, y1, x3, y3);
- 
-         if (xa > xb) {
-             float t = xa;
-             xa = xb;
-             xb = t;
+     // Orient the triangle so that its interior is on the positive side of every edge
+     Sint64 area = (Sint64)(x2 - x1) * (y3 - y1) - (Sint64)(y2 - y1) * (x3 - x1);
+     if (area == 0)
+         return;
+     if (area < 0) {
+         int tx = x2; x2 = x3; x3 = tx;
+         int ty = y2; y2 = y3; y3 = ty;
+     }
+ 
+     // Rows whose pixel centers can be inside: [min_y..max_y), within the clip
+     int min_y = y1 < y2 ? (y1 < y3 ? y1 : y3) : (y2 < y3 ? y2 : y3);
+     int max_y = y1 > y2 ? (y1 > y3 ? y1 : y3) : (y2 > y3 ? y2 : y3);
+     int y_first = min_y > clip->y0 ? min_y : clip->y0;
+     int y_end   = max_y < clip->y1 ? max_y : clip->y1;
+     if (y_first >= y_end)
+         return;
+ 
+     // Each edge is a left bound, a right bound or (if horizontal) a limit on y; a
+     // triangle has at most two edges of either kind, missing ones never restrict.
+     TriEdge e[3] = { tri_edge(x1, y1, x2, y2), tri_edge(x2, y2, x3, y3), tri_edge(x3, y3, x1, y1) };
+     TriEdge left[2], right[2];
+     int n_left = 0, n_right = 0;
+     for (int k = 0; k < 3; k++) {
+         if (e[k].dx > 0) {
+             left[n_left++] = e[k];
+         } else if (e[k].dx < 0) {
+             right[n_right++] = e[k];
+         } else if (e[k].dy > 0) {
+             Sint64 y_min = -floor_div(e[k].c, e[k].dy);
+             if (y_min > y_first) y_first = (int)(y_min < y_end ? y_min : y_end);
+         } else {
+             Sint64 y_max = floor_div(e[k].c, -e[k].dy);
+             if (y_max < (Sint64)y_end - 1) y_end = (int)(y_max + 1 > y_first ? y_max + 1 : y_first);
          }
-         int ix_a = clampi((int)xa, 0, row_len - 1);
-         int ix_b = clampi((int)xb, 0, row_len - 1);
+     }
+     if (y_first >= y_end)
+         return;
+ 
+     TriEdgeStep l0 = tri_edge_step(&left[0], y_first);
+     TriEdgeStep r0 = tri_edge_step(&right[0], y_first);
+     TriEdgeStep l1 = n_left  > 1 ? tri_edge_step(&left[1], y_first)  : tri_edge_step_const(clip->x0);
+     TriEdgeStep r1 = n_right > 1 ? tri_edge_step(&right[1], y_first) : tri_edge_step_const(clip->x1 - 1);
  
-         for (int x = ix_a; x <= ix_b; x++) {
-             int idx = y * row_len + x;
-             px[idx] = alpha_blend(px[idx], col, fmt);
+     for (int y = y_first; y < y_end; y++) {
+         if (row_sampled(y, t->row_shift)) {
+             Sint64 xa = l0.q > l1.q ? l0.q : l1.q;
+             Sint64 xb = r0.q < r1.q ? r0.q : r1.q;
+             if (xa < clip->x0) xa = clip->x0;
+             if (xb > clip->x1 - 1) xb = clip->x1 - 1;
+             if (xa <= xb)
+                 emit_span(t, (int)xa, y, (int)(xb - xa + 1), bc, fmt);
          }
+         tri_edge_advance(&l0);
+         tri_edge_advance(&l1);
+         tri_edge_advance(&r0);
+         tri_edge_advance(&r1);
      }
  }
  
+ /**
+  * @brief Computes the canvas area a gene may touch, clipped to the canvas.
+  *
+  * The rectangle is conservative: every pixel written by draw_circle() or
+  * draw_triangle() for this gene lies inside it.
+  *
+  * @param g      Gene to bound.
+  * @param width  Canvas width in pixels.
+  * @param height Canvas height in pixels.
+  * @param[out] out Bounding rectangle (possibly empty).
+  */
+ static void gene_bounds(const Gene *g, int width, int height, ClipRect *out)
+ {
+     if (gene_type(g) == SHAPE_CIRCLE) {
+         int r = g->geom.circle.radius;
+         if (r <= 0) {
+             *out = (ClipRect){ 0, 0, 0, 0 };
+             return;
+         }
+         out->x0 = clampi(g->geom.circle.cx - r,     0, width);
+         out->x1 = clampi(g->geom.circle.cx + r + 1, 0, width);
+         out->y0 = clampi(g->geom.circle.cy - r,     0, height);
+         out->y1 = clampi(g->geom.circle.cy + r + 1, 0, height);
+     } else {
+         int x1 = clampi(g->geom.triangle.x1, 0, width - 1);
+         int x2 = clampi(g->geom.triangle.x2, 0, width - 1);
+         int x3 = clampi(g->geom.triangle.x3, 0, width - 1);
+         int y1 = clampi(g->geom.triangle.y1, 0, height - 1);
+         int y2 = clampi(g->geom.triangle.y2, 0, height - 1);
+         int y3 = clampi(g->geom.triangle.y3, 0, height - 1);
+         out->x0 = (x1 < x2 ? (x1 < x3 ? x1 : x3) : (x2 < x3 ? x2 : x3));
+         out->x1 = (x1 > x2 ? (x1 > x3 ? x1 : x3) : (x2 > x3 ? x2 : x3)) + 1;
+         out->y0 = (y1 < y2 ? (y1 < y3 ? y1 : y3) : (y2 < y3 ? y2 : y3));
+         out->y1 = (y1 > y2 ? (y1 > y3 ? y1 : y3) : (y2 > y3 ? y2 : y3)) + 1;
+     }
+ }
+ 
+ /**
+  * @brief Returns a copy of @p g with its geometry scaled to pyramid level @p shift.
+  *
+  * Coordinates are divided by 2^shift (floor, so a full-resolution pixel maps to the
+  * coarse pixel containing it) and radii are rounded to the nearest coarse pixel.
+  *
+  * @param g     Gene in full-resolution coordinates.
+  * @param shift Pyramid level (0 returns @p g unchanged).
+  * @return Gene in level coordinates.
+  */
+ static inline Gene gene_at_level(const Gene *g, int shift)
+ {
+     Gene s = *g;
+     if (shift <= 0)
+         return s;
+     if (gene_type(g) == SHAPE_CIRCLE) {
+         s.geom.circle.cx     = g->geom.circle.cx >> shift;
+         s.geom.circle.cy     = g->geom.circle.cy >> shift;
+         s.geom.circle.radius = (g->geom.circle.radius + (1 << (shift - 1))) >> shift;
+     } else {
+         s.geom.triangle.x1 = g->geom.triangle.x1 >> shift;
+         s.geom.triangle.y1 = g->geom.triangle.y1 >> shift;
+         s.geom.triangle.x2 = g->geom.triangle.x2 >> shift;
+         s.geom.triangle.y2 = g->geom.triangle.y2 >> shift;
+         s.geom.triangle.x3 = g->geom.triangle.x3 >> shift;
+         s.geom.triangle.y3 = g->geom.triangle.y3 >> shift;
+     }
+     return s;
+ }
+ 
+ /**
+  * @brief Clears the sampled rows of a render target's clip rectangle.
+  *
+  * @param t Render target.
+  */
+ static void clear_target(const RenderTarget *t)
+ {
+     const ClipRect *clip = &t->clip;
+     size_t span_bytes = (size_t)(clip->x1 - clip->x0) * sizeof(Uint32);
+     for (int y = clip->y0; y < clip->y1; y++) {
+         if (!row_sampled(y, t->row_shift))
+             continue;
+         memset(target_pixel(t, clip->x0, y), 0, span_bytes);
+     }
+ }
+ 
+ /**
+  * @brief Draws one gene (already in level coordinates) into a render target.
+  *
+  * @param t Render target.
+  * @param fmt SDL_PixelFormat pointer.
+  * @param g Gene to draw.
+  */
+ static inline void draw_gene(const RenderTarget *t, const SDL_PixelFormat *fmt,
+                              const Gene *g)
+ {
+     BlendColor bc = make_blend_color(g, fmt);
+     if (gene_type(g) == SHAPE_CIRCLE) {
+         draw_circle(t, fmt,
+                      g->geom.circle.cx,
+                      g->geom.circle.cy,
+                      g->geom.circle.radius,
+                      &bc);
+     } else {
+         draw_triangle(t, fmt,
+                        g->geom.triangle.x1, g->geom.triangle.y1,
+                        g->geom.triangle.x2, g->geom.triangle.y2,
+                        g->geom.triangle.x3, g->geom.triangle.y3,
+                        &bc);
+     }
+ }
+ 
+ /**
+  * @brief Draws genes [first..last) of a chromosome over the current content of a render target.
+  *
+  * Genes whose bounding box misses the clip rectangle are skipped.
+  *
+  * @param c Pointer to the chromosome.
+  * @param first Index of the first gene to draw.
+  * @param last One past the index of the last gene to draw.
+  * @param t Render target.
+  * @param fmt SDL_PixelFormat pointer.
+  * @param width Canvas width in pixels.
+  * @param height Canvas height in pixels.
+  * @param shift Pyramid level of the canvas (genes are scaled by 2^-shift).
+  */
+ static void composite_genes(const Chromosome *c, size_t first, size_t last,
+                             const RenderTarget *t, const SDL_PixelFormat *fmt,
+                             int width, int height, int shift)
+ {
+     const ClipRect *clip = &t->clip;
+     for (size_t i = first; i < last; i++) {
+         const Gene g = gene_at_level(&c->shapes[i], shift);
+         ClipRect gb;
+         gene_bounds(&g, width, height, &gb);
+         if (gb.x1 <= clip->x0 || gb.x0 >= clip->x1 || gb.y1 <= clip->y0 || gb.y0 >= clip->y1)
+             continue;
+         draw_gene(t, fmt, &g);
+     }
+ }
+ 
+ /**
+  * @brief Composites a chromosome into the clip region of a render target.
+  *
+  * Clears the region, then draws every gene overlapping it in order. Pixels outside
+  * the clip rectangle are left untouched; pixels inside end up identical to a full
+  * render_chrom().
+  *
+  * @param c Pointer to the chromosome.
+  * @param t Render target; its clip rectangle is the region to recomposite.
+  * @param fmt SDL_PixelFormat pointer.
+  * @param width Canvas width in pixels.
+  * @param height Canvas height in pixels.
+  * @param shift Pyramid level of the canvas (genes are scaled by 2^-shift).
+  */
+ static void render_chrom_clipped(const Chromosome *c, const RenderTarget *t,
+                                  const SDL_PixelFormat *fmt, int width, int height,
+                                  int shift)
+ {
+     clear_target(t);
+     composite_genes(c, 0, c->n_shapes, t, fmt, width, height, shift);
+ }
+ 
  /**
   * @brief Renders chromosome into ARGB buffer by drawing its shapes.
   *
@@ -217,197 +745,551 @@
  
      memset(out, 0, buffer_size);
  
+     RenderTarget t = { out, row_len, { 0, 0, width, height }, 0, NULL };
      for (size_t i = 0; i < c->n_shapes; i++) {
-         const Gene *g = &c->shapes[i];
-         Uint32 col = SDL_MapRGBA(fmt, g->r, g->g, g->b, g->a);
- 
-         if (g->type == SHAPE_CIRCLE) {
-             draw_circle(out, pitch, fmt,
-                          g->geom.circle.cx,
-                          g->geom.circle.cy,
-                          g->geom.circle.radius,
-                          col, width, height);
-         } else {
-             draw_triangle(out, pitch, fmt,
-                            g->geom.triangle.x1, g->geom.triangle.y1,
-                            g->geom.triangle.x2, g->geom.triangle.y2,
-                            g->geom.triangle.x3, g->geom.triangle.y3,
-                            col, width, height);
-         }
+         draw_gene(&t, fmt, &c->shapes[i]);
      }
  }
  
  /**
-  * @brief Computes MSE fitness for the candidate vs. reference (RGB only).
+  * @brief Sums the squared RGB differences over a rectangle of two ARGB canvases.
   *
-  * This function computes the Mean Squared Error (MSE) between the candidate image and the reference image.
-  * It calculates the squared difference of the RGB channels for each pixel and averages the result.
-  *
-  * @param cand Pointer to candidate ARGB buffer.
-  * @param ref Pointer to reference ARGB buffer.
-  * @param count_px Number of pixels to process.
-  * @return Mean Squared Error over RGB channels.
+  * @param cand Candidate canvas.
+  * @param ref Reference canvas (same layout as @p cand).
+  * @param row_len Pixels per row of both canvases.
+  * @param r Rectangle to compare.
+  * @param row_shift Row sampling: only sampled rows are compared.
+  * @return Exact sum of squared errors over the compared rows (not normalized).
   */
- static inline double fitness_scalar(const Uint32 *cand, const Uint32 *ref, int count_px)
+ static double region_sse(const Uint32 *cand, const Uint32 *ref, int row_len, const ClipRect *r,
+                          int row_shift)
  {
-     double err = 0.0;
-     for (int i = 0; i < count_px; i++) {
-         int dr = ((cand[i] >> 16) & 0xFF) - ((ref[i] >> 16) & 0xFF);
-         int dg = ((cand[i] >> 8) & 0xFF) - ((ref[i] >> 8) & 0xFF);
-         int db = (cand[i] & 0xFF) - (ref[i] & 0xFF);
-         err += (double)(dr*dr + dg*dg + db*db);
+     GASseSpanFunc sse_span = ga_kernels()->sse_span;
+     Uint64 err = 0;
+     for (int y = r->y0; y < r->y1; y++) {
+         if (!row_sampled(y, row_shift))
+             continue;
+         size_t row = (size_t)y * row_len + r->x0;
+         err += sse_span(cand + row, ref + row, r->x1 - r->x0);
      }
-     return err / (double)count_px;
+     return (double)err;
  }
  
- #ifdef __AVX2__
  /**
-  * @brief AVX2 accelerated MSE (RGB channels only).
-  *
-  * This function computes the Mean Squared Error (MSE) between the candidate image and the reference image
-  * using AVX2 instructions for acceleration. It calculates the squared difference of the RGB channels
-  * for each pixel and averages the result.
+  * @brief Largest dirty area, as a fraction of the canvas, still worth an incremental update.
   *
-  * @param cand Pointer to candidate ARGB buffer.
-  * @param ref Pointer to reference ARGB buffer.
-  * @param count_px Number of pixels.
-  * @return MSE over RGB channels.
+  * The incremental path composites the dirty rectangle twice (parent and child), so
+  * beyond roughly a third of the canvas a plain full render is cheaper.
   */
+ #define INCREMENTAL_MAX_AREA_DIV 3
+ 
  /**
- * @brief AVX2 accelerated MSE (RGB channels only).
+  * @brief Computes the union bounding box of the genes that differ between @p c and its parent.
+  *
+  * Both the old (parent) and new (child) version of every changed gene are included, since
+  * the area the old shape covered must be recomposited as well.
+  *
+  * @param c Child chromosome, with c->parent set and the same gene count.
+  * @param width Canvas width in pixels.
+  * @param height Canvas height in pixels.
+  * @param shift Pyramid level of the canvas.
+  * @param[out] dirty Union rectangle (empty if the genomes are identical).
+  */
+ static void dirty_bounds(const Chromosome *c, int width, int height, int shift, ClipRect *dirty)
+ {
+     *dirty = (ClipRect){ 0, 0, 0, 0 };
+     const Gene *pg = c->parent->shapes;
+     for (size_t i = 0; i < c->n_shapes; i++) {
+         if (memcmp(&pg[i], &c->shapes[i], sizeof(Gene)) == 0)
+             continue;
+         ClipRect gb;
+         Gene lg = gene_at_level(&pg[i], shift);
+         gene_bounds(&lg, width, height, &gb);
+         clip_union(dirty, &gb);
+         lg = gene_at_level(&c->shapes[i], shift);
+         gene_bounds(&lg, width, height, &gb);
+         clip_union(dirty, &gb);
+     }
+ }
+ 
+/**
+ * @brief Downsamples an ARGB8888 image by 2 in both directions (2x2 box filter, rounded).
  *
- * This function computes the Mean Squared Error (MSE) between the candidate image and the reference image
- * using AVX2 instructions for acceleration. It calculates the squared difference of the RGB channels
- * for each pixel and averages the result.
+ * @param src Source image, tightly packed.
+ * @param sw Source width.
+ * @param dst Destination image of (sw / 2) x dh pixels, tightly packed.
+ * @param dw Destination width.
+ * @param dh Destination height.
+ */
+static void downsample_2x2(const Uint32 *src, int sw, Uint32 *dst, int dw, int dh)
+{
+    for (int y = 0; y < dh; y++) {
+        const Uint32 *r0 = src + (size_t)(2 * y) * sw;
+        const Uint32 *r1 = r0 + sw;
+        for (int x = 0; x < dw; x++) {
+            Uint32 a = r0[2 * x], b = r0[2 * x + 1], c = r1[2 * x], d = r1[2 * x + 1];
+            Uint32 out = 0xFF000000u;
+            for (int sh = 0; sh < 24; sh += 8) {
+                Uint32 sum = ((a >> sh) & 0xFF) + ((b >> sh) & 0xFF)
+                           + ((c >> sh) & 0xFF) + ((d >> sh) & 0xFF);
+                out |= ((sum + 2) >> 2) << sh;
+            }
+            dst[(size_t)y * dw + x] = out;
+        }
+    }
+}
+
+int ga_pyramid_build(GAImagePyramid *pyr, const Uint32 *base, int width, int height, int levels)
+{
+    if (!pyr || !base || width <= 0 || height <= 0 || levels < 1 || levels > GA_PYRAMID_MAX_LEVELS)
+        return -1;
+
+    memset(pyr, 0, sizeof(*pyr));
+    pyr->levels[0] = base;
+    pyr->width[0]  = width;
+    pyr->height[0] = height;
+    pyr->count     = 1;
+
+    for (int k = 1; k < levels; k++) {
+        int w = pyr->width[k - 1] / 2;
+        int h = pyr->height[k - 1] / 2;
+        if (w < 1 || h < 1)
+            break;
+        Uint32 *px = (Uint32 *)malloc((size_t)w * (size_t)h * sizeof(Uint32));
+        if (!px) {
+            ga_pyramid_free(pyr);
+            return -1;
+        }
+        downsample_2x2(pyr->levels[k - 1], pyr->width[k - 1], px, w, h);
+        pyr->levels[k] = px;
+        pyr->width[k]  = w;
+        pyr->height[k] = h;
+        pyr->count     = k + 1;
+    }
+    return 0;
+}
+
+void ga_pyramid_free(GAImagePyramid *pyr)
+{
+    if (!pyr)
+        return;
+    for (int k = 1; k < pyr->count; k++) {
+        free((void *)pyr->levels[k]);
+    }
+    memset(pyr, 0, sizeof(*pyr));
+}
+
+/**
+ * @brief Refines the evaluation (row density, then pyramid level) once the best fitness
+ *        stops improving.
  *
- * @param cand Pointer to candidate ARGB buffer.
- * @param ref Pointer to reference ARGB buffer.
- * @param count_px Number of pixels.
- * @return MSE over RGB channels.
+ * Runs on the GA thread between generations, so GAFitnessParams may be modified
+ * without synchronization with the evaluation workers.
  */
-static inline double fitness_avx2(const Uint32 *cand, const Uint32 *ref, int count_px)
-
-    // Define masks for extracting the RGB components from the ARGB values
-    __m256i maskR = _mm256_set1_epi32(0x00FF0000); // Mask for the red component
-    __m256i maskG = _mm256_set1_epi32(0x0000FF00); // Mask for the green component
-    __m256i maskB = _mm256_set1_epi32(0x000000FF); // Mask for the blue component
-    // Initialize the accumulator for the sum of squared differences to zero
-    __m256d accum = _mm256_setzero_pd();
-    // Calculate the limit for the main loop, processing 8 pixels at a time
-    int limit = (count_px / 8) * 8;
-    int i = 0;
-    // Main loop: process 8 pixels at a time using AVX2 instructions
-    for (; i < limit; i += 8) {
-        // Load 8 candidate and reference pixels into AVX2 registers
-        __m256i C = _mm256_loadu_si256((const __m256i*)(cand + i));
-        __m256i R = _mm256_loadu_si256((const __m256i*)(ref + i));
-        // Extract the RGB components from the candidate pixels
-        __m256i cR = _mm256_srli_epi32(_mm256_and_si256(C, maskR), 16); // Red component
-        __m256i cG = _mm256_srli_epi32(_mm256_and_si256(C, maskG), 8);  // Green component
-        __m256i cB = _mm256_and_si256(C, maskB);                         // Blue component
-        // Extract the RGB components from the reference pixels
-        __m256i rR = _mm256_srli_epi32(_mm256_and_si256(R, maskR), 16); // Red component
-        __m256i rG = _mm256_srli_epi32(_mm256_and_si256(R, maskG), 8);  // Green component
-        __m256i rB = _mm256_and_si256(R, maskB);                         // Blue component
-        // Calculate the differences between the candidate and reference RGB components
-        __m256 dR = _mm256_cvtepi32_ps(_mm256_sub_epi32(cR, rR)); // Difference in red component
-        __m256 dG = _mm256_cvtepi32_ps(_mm256_sub_epi32(cG, rG)); // Difference in green component
-        __m256 dB = _mm256_cvtepi32_ps(_mm256_sub_epi32(cB, rB)); // Difference in blue component
-        // Calculate the sum of squared differences for the RGB components
-        __m256 sum = _mm256_fmadd_ps(dR, dR,                             // Sum of squared differences for red
-                           _mm256_fmadd_ps(dG, dG,                      // Sum of squared differences for green
-                                           _mm256_mul_ps(dB, dB)));      // Sum of squared differences for blue
-
-        // Convert the sum of squared differences to double precision and accumulate the results
-        __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(sum));       // Lower half of the sum
-        __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(sum, 1));    // Upper half of the sum
-        accum = _mm256_add_pd(accum, _mm256_add_pd(lo, hi));            // Accumulate the results
+int ga_refine_generation_callback(const GAGenerationInfo *info, void *user_data)
+{
+    GAFitnessParams *p = (GAFitnessParams*)user_data;
+    if (!info || !p)
+        return 0;
+
+    int can_densify = p->sample_shift > 0;
+    int can_refine  = p->pyramid && p->level > 0;
+    if (!can_densify && !can_refine)
+        return 0;
+
+    // Any sufficient gain restarts the stall window
+    if (info->best_fitness < p->stall_best * (1.0 - p->stall_tolerance)) {
+        p->stall_best  = info->best_fitness;
+        p->stall_count = 0;
+        return 0;
     }
-    // Process any remaining pixels that were not handled in the main loop
-    double leftover = 0.0;
-    for (; i < count_px; i++) {
-        // Calculate the differences between the candidate and reference RGB components
-        int dr = ((cand[i] >> 16) & 0xFF) - ((ref[i] >> 16) & 0xFF); // Difference in red component
-        int dg = ((cand[i] >> 8) & 0xFF) - ((ref[i] >> 8) & 0xFF);   // Difference in green component
-        int db = (cand[i] & 0xFF) - (ref[i] & 0xFF);                 // Difference in blue component
-        // Accumulate the sum of squared differences for the remaining pixels
-        leftover += (double)(dr*dr + dg*dg + db*db);
+    if (++p->stall_count < p->stall_generations)
+        return 0;
+
+    // Stalled: double the row density, or move one level finer and restart sparse.
+    // Either way the fitness values measured so far are not comparable any more.
+    if (can_densify) {
+        p->sample_shift--;
+    } else {
+        p->level--;
+        p->sample_shift = p->sample_shift_max;
     }
-    // Store the accumulated sum of squared differences into a temporary array
-    double tmp[4];
-    _mm256_storeu_pd(tmp, accum);
-    // Calculate the total sum of squared differences
-    double sum_avx = tmp[0] + tmp[1] + tmp[2] + tmp[3];
-    // Return the mean squared error (MSE)
-    return (sum_avx + leftover) / (double)count_px;
+    p->stall_best  = 1.0e30;
+    p->stall_count = 0;
+    return 1;
 }
-#endif /* __AVX2__ */
 
- 
- /**
-  * @brief Renders chromosome into scratch buffer, then computes MSE (RGB).
-  *
-  * This function renders the chromosome into a scratch buffer and then computes the Mean Squared Error (MSE)
-  * between the rendered image and the reference image. It uses the fitness_scalar function for the MSE calculation
-  * unless AVX2 is available, in which case it uses the fitness_avx2 function for accelerated computation.
-  *
-  * @param c Chromosome pointer.
-  * @param user_data Pointer to GAFitnessParams.
-  * @return MSE score or large penalty on error.
-  */
- /**
- * @brief Renders chromosome into scratch buffer, then computes MSE (RGB).
+/**
+ * @brief Returns the per-worker scratch size required by ga_sdl_fitness_callback().
  *
- * This function renders the chromosome into a scratch buffer and then computes the Mean Squared Error (MSE)
- * between the rendered image and the reference image. It uses the fitness_scalar function for the MSE calculation
- * unless AVX2 is available, in which case it uses the fitness_avx2 function for accelerated computation.
+ * One full ARGB canvas (pitch * height bytes) is needed per worker; coarser pyramid
+ * levels use a prefix of it.
  *
- * @param c Chromosome pointer.
- * @param user_data Pointer to GAFitnessParams.
- * @return MSE score or large penalty on error.
+ * @param p Fitness parameters.
+ * @return Scratch size in bytes, or 0 if @p p is invalid.
  */
-double ga_sdl_fitness_callback(const Chromosome *c, void *user_data)
+size_t ga_fitness_scratch_size(const GAFitnessParams *p)
 {
-    // Check if the chromosome or user data is null, return a large penalty if true
-    if (!c || !user_data)
-        return 1.0e30;
+    if (!p || p->pitch <= 0 || p->height <= 0)
+        return 0;
+    return (size_t)p->pitch * (size_t)p->height;
+}
 
-    // Cast the user data to GAFitnessParams pointer
-    GAFitnessParams *p = (GAFitnessParams*)user_data;
-    // Check if the reference pixels, scratch pixels, or pixel format is null, return a large penalty if true
-    if (!p->ref_pixels || !p->scratch_pixels || !p->fmt)
-        return 1.0e30;
+/**
+ * @brief Resolution, buffers and pixel counts of one evaluation pass.
+ *
+ * Depends only on the fitness parameters, the worker and the row sampling, so a batch
+ * of chromosomes evaluated by one worker shares a single setup.
+ */
+typedef struct {
+    Uint32 *canvas;       /**< Worker's canvas (start of its scratch area). */
+    const Uint32 *ref;    /**< Reference pixels at the evaluated level. */
+    int width, height;    /**< Size of the evaluated level in pixels. */
+    int pitch, row_len;   /**< Row stride of canvas and reference (bytes, pixels). */
+    int shift;            /**< Pyramid level the genes are scaled to. */
+    int row_shift;        /**< Row sampling (0 scores every row: exact MSE). */
+    int level_px;         /**< Pixels of the level. */
+    int count_px;         /**< Pixels actually scored. */
+} EvalSetup;
+
+/**
+ * @brief Validates the fitness parameters and the worker's scratch, and picks the level.
+ *
+ * @param p Fitness parameters.
+ * @param ectx Evaluation context of the calling worker.
+ * @param row_shift Row sampling (0 scores every row: exact MSE).
+ * @param[out] s Setup to fill.
+ * @return 0 on success, -1 if nothing can be evaluated (callers return the penalty).
+ */
+static int eval_setup(const GAFitnessParams *p, const GAEvalContext *ectx, int row_shift,
+                      EvalSetup *s)
+{
+    // Check if the reference pixels or pixel format is null
+    if (!p->ref_pixels || !p->fmt)
+        return -1;
 
     // Calculate the number of pixels per row
     int row_len = p->pitch / 4;
-    // Validate the width and height of the image
-    // Return a large penalty if the width is less than or equal to 0,
-    // the height is less than or equal to 0, or the width is greater than the number of pixels per row
+    // Validate the width and height of the image: both must be positive,
+    // and the width may not exceed the number of pixels per row
     if (p->width <= 0 || p->height <= 0 || p->width > row_len)
-        return 1.0e30;
+        return -1;
 
     // Calculate the total buffer size
     size_t buffer_size = (size_t)p->height * (size_t)p->pitch;
-    // Validate the buffer size
-    // Return a large penalty if the buffer size is not consistent with the height and pitch
+    // Validate the buffer size: it must be consistent with the height and pitch
     if ((buffer_size / (size_t)p->pitch) != (size_t)p->height)
+        return -1;
+
+    // The worker's scratch area must hold a full canvas
+    Uint32 *canvas = (Uint32*)ectx->scratch;
+    if (!canvas || ectx->scratch_size < buffer_size)
+        return -1;
+
+    // Pick the resolution to evaluate at: the full image, or the current pyramid level
+    const Uint32 *ref = p->ref_pixels;
+    int width = p->width, height = p->height, pitch = p->pitch, shift = 0;
+    if (p->pyramid && p->level > 0 && p->level < p->pyramid->count) {
+        shift  = p->level;
+        ref    = p->pyramid->levels[shift];
+        width  = p->pyramid->width[shift];
+        height = p->pyramid->height[shift];
+        pitch  = width * (int)sizeof(Uint32);
+        row_len = width;
+    }
+
+    // Calculate the total number of pixels, and how many of them are scored
+    int level_px = width * height;
+    int count_px = width * sampled_row_count(height, row_shift);
+    if (level_px <= 0 || count_px <= 0)
+        return -1;
+
+    *s = (EvalSetup){ canvas, ref, width, height, pitch, row_len, shift, row_shift,
+                      level_px, count_px };
+    return 0;
+}
+
+/**
+ * @brief Renders chromosome into the worker's scratch buffer, then computes MSE (RGB).
+ *
+ * Shared body of the fitness callbacks, once eval_setup() has succeeded.
+ *
+ * @param c Chromosome pointer.
+ * @param p Fitness parameters.
+ * @param s Setup of the pass (from eval_setup() with the same @p p).
+ * @param incremental Non-zero to allow re-scoring from the parent's fitness.
+ * @return MSE score (over the sampled rows).
+ */
+static double evaluate_chrom(const Chromosome *c, const GAFitnessParams *p,
+                             const EvalSetup *s, int incremental)
+{
+    Uint32 *canvas = s->canvas;
+    const Uint32 *ref = s->ref;
+    int width = s->width, height = s->height, row_len = s->row_len;
+    int shift = s->shift, row_shift = s->row_shift, count_px = s->count_px;
+
+    // Incremental path: only the area touched by genes that differ from the parent changes,
+    // so swap the parent's error over that area for the child's.
+    if (incremental && c->parent && c->parent->n_shapes == c->n_shapes
+        && c->parent_fitness < 1.0e29) {
+        ClipRect dirty;
+        dirty_bounds(c, width, height, shift, &dirty);
+        if (clip_empty(&dirty))
+            return c->parent_fitness;
+
+        long long area = (long long)(dirty.x1 - dirty.x0) * (long long)(dirty.y1 - dirty.y0);
+        if (area * INCREMENTAL_MAX_AREA_DIV <= (long long)s->level_px) {
+            double parent_sse = nearbyint(c->parent_fitness * (double)count_px);
+            RenderTarget t = { canvas, row_len, dirty, row_shift, NULL };
+            render_chrom_clipped(c->parent, &t, p->fmt, width, height, shift);
+            double old_sse = region_sse(canvas, ref, row_len, &dirty, row_shift);
+            render_chrom_clipped(c, &t, p->fmt, width, height, shift);
+            double new_sse = region_sse(canvas, ref, row_len, &dirty, row_shift);
+            return (parent_sse - old_sse + new_sse) / (double)count_px;
+        }
+    }
+
+    // Render the chromosome into the worker's canvas
+    if (shift == 0 && row_shift == 0) {
+        render_chrom(c, canvas, s->pitch, p->fmt, width, height);
+        // Compute the MSE with the squared-error kernel selected for this CPU
+        return (double)ga_kernels()->sse_span(canvas, ref, count_px) / (double)count_px;
+    }
+    ClipRect full = { 0, 0, width, height };
+    RenderTarget t = { canvas, row_len, full, row_shift, NULL };
+    render_chrom_clipped(c, &t, p->fmt, width, height, shift);
+    return region_sse(canvas, ref, row_len, &full, row_shift) / (double)count_px;
+}
+
+/**
+ * @brief Fitness callback: MSE at the current pyramid level and row sampling.
+ *
+ * This function renders the chromosome into the scratch area of the calling worker's
+ * evaluation context and then computes the Mean Squared Error (MSE) between the rendered
+ * image and the reference image. Since every worker owns its canvas, concurrent calls
+ * never race on the rendered pixels. Children whose changed genes cover a small area
+ * are re-scored incrementally from their parent (see GAFitnessParams.incremental).
+ * While GAFitnessParams.sample_shift is non-zero, only the sampled rows are rasterized
+ * and scored; the sample set only changes between generations, so every chromosome of
+ * a generation is ranked on the same pixels.
+ * The squared-error reduction uses the kernel variant selected at startup
+ * (see ga_kernels_select()).
+ *
+ * @param c Chromosome pointer.
+ * @param user_data Pointer to GAFitnessParams.
+ * @param ectx Evaluation context of the calling worker.
+ * @return MSE score or large penalty on error.
+ */
+double ga_sdl_fitness_callback(const Chromosome *c, void *user_data,
+                               const GAEvalContext *ectx)
+{
+    // Check if the chromosome, user data or evaluation context is null, return a large penalty if true
+    if (!c || !user_data || !ectx)
         return 1.0e30;
 
-    // Calculate the total number of pixels
-    int count_px = p->width * p->height;
-    // Validate the number of pixels
-    // Return a large penalty if the number of pixels is less than or equal to 0
-    if (count_px <= 0)
+    const GAFitnessParams *p = (const GAFitnessParams*)user_data;
+    EvalSetup s;
+    if (eval_setup(p, ectx, p->sample_shift, &s) != 0)
         return 1.0e30;
+    return evaluate_chrom(c, p, &s, p->incremental);
+}
 
-    // Render the chromosome into the scratch buffer
-    render_chrom(c, p->scratch_pixels, p->pitch, p->fmt, p->width, p->height);
-    // Compute the MSE using AVX2 if available, otherwise use the scalar implementation
-    #ifdef __AVX2__
-        // Use the AVX2-accelerated MSE calculation
-        return fitness_avx2(p->scratch_pixels, p->ref_pixels, count_px);
-    #else
-        // Use the scalar MSE calculation
-        return fitness_scalar(p->scratch_pixels, p->ref_pixels, count_px);
-    #endif
+/**
+ * @brief Batch fitness callback: ga_sdl_fitness_callback() over a worker's whole slice.
+ *
+ * Parameters are validated and the evaluated level is resolved once for the batch.
+ * Every chromosome gets the same score it would get from ga_sdl_fitness_callback().
+ *
+ * @param cs Chromosomes to evaluate.
+ * @param fitness Output: one MSE score (or large penalty) per chromosome.
+ * @param count Number of chromosomes.
+ * @param user_data Pointer to GAFitnessParams.
+ * @param ectx Evaluation context of the calling worker.
+ */
+void ga_sdl_batch_fitness_callback(const Chromosome *const *cs, double *fitness, size_t count,
+                                   void *user_data, const GAEvalContext *ectx)
+{
+    if (!cs || !fitness)
+        return;
+
+    const GAFitnessParams *p = (const GAFitnessParams*)user_data;
+    EvalSetup s;
+    int ok = p && ectx && eval_setup(p, ectx, p->sample_shift, &s) == 0;
+    for (size_t i = 0; i < count; i++)
+        fitness[i] = (ok && cs[i]) ? evaluate_chrom(cs[i], p, &s, p->incremental) : 1.0e30;
+}
+
+/**
+ * @brief Exact fitness callback: MSE over every row of the current pyramid level.
+ *
+ * Never uses the incremental path, since the parent's fitness may be a sampled estimate.
+ *
+ * @param c Chromosome pointer.
+ * @param user_data Pointer to GAFitnessParams.
+ * @param ectx Evaluation context of the calling thread.
+ * @return MSE score or large penalty on error.
+ */
+double ga_sdl_exact_fitness_callback(const Chromosome *c, void *user_data,
+                                     const GAEvalContext *ectx)
+{
+    if (!c || !user_data || !ectx)
+        return 1.0e30;
+
+    const GAFitnessParams *p = (const GAFitnessParams*)user_data;
+    EvalSetup s;
+    if (eval_setup(p, ectx, 0, &s) != 0)
+        return 1.0e30;
+    return evaluate_chrom(c, p, &s, 0);
+}
+
+struct GAColorTables {
+    Uint32 *levels[GA_PYRAMID_MAX_LEVELS]; /**< Per level: (height + 1) rows of (width + 1) RGB triples. */
+    int count;                             /**< Number of valid levels. */
+};
+
+/**
+ * @brief Builds the summed-area table of an ARGB8888 image.
+ *
+ * Entry (y, x) holds the R, G, B sums over [0..x) x [0..y), modulo 2^32.
+ *
+ * @param px Image pixels.
+ * @param row_len Pixels per image row.
+ * @param width Image width.
+ * @param height Image height.
+ * @return New table, or NULL on allocation failure.
+ */
+static Uint32 *build_color_sat(const Uint32 *px, int row_len, int width, int height)
+{
+    size_t stride = (size_t)(width + 1) * 3;
+    Uint32 *sat = (Uint32 *)calloc((size_t)(height + 1) * stride, sizeof(Uint32));
+    if (!sat)
+        return NULL;
+    for (int y = 0; y < height; y++) {
+        const Uint32 *src = px + (size_t)y * row_len;
+        const Uint32 *above = sat + (size_t)y * stride;
+        Uint32 *row = sat + (size_t)(y + 1) * stride;
+        Uint32 run[3] = { 0, 0, 0 };
+        for (int x = 0; x < width; x++) {
+            run[0] += (src[x] >> 16) & 0xFF;
+            run[1] += (src[x] >> 8) & 0xFF;
+            run[2] += src[x] & 0xFF;
+            for (int ch = 0; ch < 3; ch++) {
+                row[(size_t)(x + 1) * 3 + ch] = above[(size_t)(x + 1) * 3 + ch] + run[ch];
+            }
+        }
+    }
+    return sat;
+}
+
+GAColorTables *ga_color_tables_create(const GAFitnessParams *p)
+{
+    if (!p || !p->ref_pixels || !p->fmt || p->fmt->format != SDL_PIXELFORMAT_ARGB8888
+        || p->width <= 0 || p->height <= 0 || p->pitch / 4 < p->width)
+        return NULL;
+
+    GAColorTables *t = (GAColorTables *)calloc(1, sizeof(GAColorTables));
+    if (!t)
+        return NULL;
+    int levels = p->pyramid ? p->pyramid->count : 1;
+    for (int k = 0; k < levels; k++) {
+        const Uint32 *px = k == 0 ? p->ref_pixels : p->pyramid->levels[k];
+        int w = k == 0 ? p->width : p->pyramid->width[k];
+        int h = k == 0 ? p->height : p->pyramid->height[k];
+        int row_len = k == 0 ? p->pitch / 4 : w;
+        t->levels[k] = build_color_sat(px, row_len, w, h);
+        if (!t->levels[k]) {
+            ga_color_tables_destroy(t);
+            return NULL;
+        }
+        t->count = k + 1;
+    }
+    return t;
+}
+
+void ga_color_tables_destroy(GAColorTables *tables)
+{
+    if (!tables)
+        return;
+    for (int k = 0; k < tables->count; k++) {
+        free(tables->levels[k]);
+    }
+    free(tables);
+}
+
+/**
+ * @brief Replaces the RGB color of gene @p k by the least-squares optimum over the canvas beneath it.
+ *
+ * A covered pixel blends to ((255 - a) * B + a * C) / 255 over canvas value B, so the
+ * squared error against reference R is minimal for C = (255 * sum R - (255 - a) * sum B)
+ * / (a * N) per channel, N being the covered pixel count. The blend kernels round that
+ * quotient down, half a level on average, so R + 1/2 is targeted instead of R.
+ *
+ * @param c Chromosome being optimized.
+ * @param k Index of the gene to solve.
+ * @param p Fitness parameters.
+ * @param s Setup of the current level and row sampling.
+ * @param sat Summed-area table of the reference at that level.
+ */
+static void solve_gene_color(Chromosome *c, size_t k, const GAFitnessParams *p,
+                             const EvalSetup *s, const Uint32 *sat)
+{
+    Gene *g = &c->shapes[k];
+    if (g->a == 0)
+        return;
+    Gene lg = gene_at_level(g, s->shift);
+    ClipRect gb;
+    gene_bounds(&lg, s->width, s->height, &gb);
+    if (clip_empty(&gb))
+        return;
+
+    // Canvas beneath the gene, over its bounding box only
+    RenderTarget t = { s->canvas, s->row_len, gb, s->row_shift, NULL };
+    clear_target(&t);
+    composite_genes(c, 0, k, &t, p->fmt, s->width, s->height, s->shift);
+
+    // Coverage statistics of the gene over that canvas
+    ColorSums sums = { sat, s->width + 1, 0, { 0, 0, 0 }, { 0, 0, 0 } };
+    t.sums = &sums;
+    draw_gene(&t, p->fmt, &lg);
+    if (sums.count == 0)
+        return;
+
+    double a = (double)g->a;
+    Uint8 rgb[3];
+    for (int ch = 0; ch < 3; ch++) {
+        double v = (255.0 * ((double)sums.ref[ch] + 0.5 * (double)sums.count)
+                    - (255.0 - a) * (double)sums.under[ch]) / (a * (double)sums.count);
+        rgb[ch] = (Uint8)(v <= 0.0 ? 0 : v >= 255.0 ? 255 : lrint(v));
+    }
+    g->r = rgb[0];
+    g->g = rgb[1];
+    g->b = rgb[2];
+}
+
+void ga_sdl_solve_colors_callback(Chromosome *c, void *user_data, const GAEvalContext *ectx)
+{
+    GAFitnessParams *p = (GAFitnessParams *)user_data;
+    if (!c || !p || !ectx || !p->color_tables || p->color_solve_max_genes <= 0)
+        return;
+    if (!c->parent || c->parent->n_shapes != c->n_shapes)
+        return;
+
+    EvalSetup s;
+    if (eval_setup(p, ectx, p->sample_shift, &s) != 0 || s.shift >= p->color_tables->count)
+        return;
+    const Uint32 *sat = p->color_tables->levels[s.shift];
+
+    // Only small edits (mutations) are solved; crossover rewrites too many genes to pay off
+    const Gene *pg = c->parent->shapes;
+    int changed = 0;
+    for (size_t i = 0; i < c->n_shapes; i++) {
+        if (memcmp(&pg[i], &c->shapes[i], sizeof(Gene)) != 0 && ++changed > p->color_solve_max_genes)
+            return;
+    }
+    for (size_t i = 0; i < c->n_shapes && changed > 0; i++) {
+        if (memcmp(&pg[i], &c->shapes[i], sizeof(Gene)) == 0)
+            continue;
+        solve_gene_color(c, i, p, &s, sat);
+        changed--;
+    }
 }
@@ -9,6 +9,11 @@
  */
 
  #include "../includes/genetic_algorithm/genetic_art.h"
+ #include "../includes/genetic_algorithm/ga_chromosome_pool.h"
+ #include "../includes/genetic_algorithm/ga_fitness_cache.h"
+ #include "../includes/genetic_algorithm/ga_fitness_scan.h"
+ #include "../includes/genetic_algorithm/ga_mailbox.h"
+ #include "../includes/genetic_algorithm/ga_random.h"
  #include <stdlib.h>
  #include <string.h>
  #include <stdio.h>
@@ -33,37 +38,58 @@
  /**
   * @brief Island Model parameters.
   *
-  * The constants below define default values for the island-based GA.
+  * The constants below are the defaults used for GAParams fields left at 0.
   * Adjusting these (e.g., number of islands, migration interval, etc.)
   * can tailor the GA dynamics.
   */
- #define FIT_MAX_WORKERS    8
- #define ISLAND_COUNT       4    /**< Default number of islands (threads). */
- #define MIGRATION_INTERVAL 5    /**< Generations between migrations. */
- #define MIGRANTS_PER_ISL   1    /**< Number of elite copies exchanged. */
+ #define ISLAND_COUNT       4    /**< Default number of islands. */
+ #define MIGRATION_INTERVAL 5    /**< Default generations between migrations. */
+ #define MIGRANTS_PER_ISL   1    /**< Default number of elite copies exchanged. */
  
  /**
   * @brief Forward declarations for local helper functions performing standard GA operations.
   *
   * These operations (e.g., crossover, random init, mutation) do not rely on any SDL or pixel logic.
   */
- static void random_init_chrom(Chromosome *c);
- static void mutate_gene(Gene *g);
+ static void random_init_chrom(Chromosome *c, GARandom *rng);
+ static void mutate_gene(Gene *g, GARandom *rng);
  static void crossover(const Chromosome *a, const Chromosome *b, Chromosome *o);
+ static void breed_child(GAContext *ctx, Chromosome **pop, const double *fit, int start, int end,
+                         Chromosome *child, GARandom *rng);
  
  /**
   * @brief Data structure used for each thread's fitness evaluation task.
   *
-  * Contains a slice of the population indices, a pointer to the GAContext,
-  * and a barrier for synchronizing thread operations.
+  * Contains a pointer to the GAContext, a barrier for synchronizing thread operations,
+  * and the worker's private buffers and counters. Work itself is claimed in chunks
+  * from the shared cursor g_eval_next.
   */
  typedef struct FitTask {
-     int first;             /**< First index (inclusive) of the population slice. */
-     int last;              /**< Last index (exclusive) of the population slice. */
+     _Alignas(GA_CACHE_LINE)
      struct GAContext *ctx; /**< Shared GAContext pointer, provides fitness func and data. */
      pthread_barrier_t *bar;/**< Barrier for thread synchronization. */
+     GAEvalContext eval;    /**< Worker-private evaluation context (scratch canvas). */
+     const Chromosome **batch;  /**< Chromosomes handed to batch_fitness_func (chunk length). */
+     double *batch_fitness;     /**< Scores returned by batch_fitness_func (chunk length). */
+     GAFitnessKey *batch_keys;  /**< Genome keys of the batch (chunk length, with a fitness cache). */
+     GAFitnessCache *fcache;    /**< Shared genome hash -> fitness cache, or NULL. */
+     unsigned long long skipped;       /**< Clean chromosomes not re-evaluated (since last report). */
+     unsigned long long cache_lookups; /**< Fitness cache lookups (since last report). */
+     unsigned long long cache_hits;    /**< Fitness cache hits (since last report). */
+     unsigned long long busy_ns;       /**< Time spent evaluating chunks (since last report). */
+     unsigned long long chunks;        /**< Chunks claimed (since last report). */
  } FitTask;
  
+ /**
+  * @brief Island range structure indicating the start and end indices for each island.
+  *
+  * Each island receives a contiguous slice [start..end] of the population array.
+  */
+ typedef struct {
+     int start; /**< Start index of the slice (inclusive). */
+     int end;   /**< End index of the slice (inclusive). */
+ } IslandRange;
+ 
  /**
   * @brief Global pointer allowing worker threads to access the population being evaluated.
   *
@@ -73,17 +99,254 @@
  static Chromosome *volatile *g_eval_pop = NULL;
  
  /**
-  * @brief Worker thread function that updates the .fitness of each Chromosome in [first..last)
-  *        by calling ctx->fitness_func.
+  * @brief Fitness array of g_eval_pop (same indices), written by the workers as they score.
+  */
+ static double *g_eval_fit = NULL;
+ 
+ /**
+  * @brief Work done by the workers on each slot of g_eval_pop during one parallel phase.
+  */
+ typedef enum {
+     GA_PHASE_EVAL,  /**< Evaluate the chromosomes already in place. */
+     GA_PHASE_INIT,  /**< Randomize the chromosomes in place, then evaluate them. */
+     GA_PHASE_BREED, /**< Breed children of g_parents (island by island) into the chromosomes
+                          in place, except for survivors of g_parents, then evaluate them. */
+     GA_PHASE_STOP   /**< Leave the worker loop. */
+ } GAPhase;
+ 
+ /**
+  * @brief Description of the current parallel phase, set by the GA thread before the
+  *        "start" barrier and read-only for the workers until the "done" barrier.
+  */
+ static GAPhase g_phase = GA_PHASE_EVAL;
+ static Chromosome **g_parents = NULL;   /**< Previous generation (GA_PHASE_BREED). */
+ static const double *g_parent_fit = NULL; /**< Fitness array of g_parents (GA_PHASE_BREED). */
+ static const IslandRange *g_isl = NULL; /**< Island ranges (GA_PHASE_BREED). */
+ static int g_islands = 0;               /**< Number of islands (GA_PHASE_BREED). */
+ static uint64_t g_phase_id = 0;         /**< Sequence number of the phase (random streams). */
+ 
+ /**
+  * @brief Size of g_eval_pop, and index of its next chromosome not yet claimed by a worker.
+  *
+  * Both are reset by the GA thread before the "start" barrier; workers then claim chunks
+  * of g_eval_pop by advancing g_eval_next (see claim_chunk()).
+  */
+ static int g_eval_count = 0;
+ static atomic_int g_eval_next;
+ 
+ /**
+  * @brief Wall-clock time the GA thread spent waiting for parallel phases (since last report).
+  */
+ static unsigned long long g_eval_wall_ns = 0;
+ 
+ /**
+  * @brief Reads the monotonic clock in nanoseconds.
+  */
+ static inline unsigned long long now_ns(void)
+ {
+     struct timespec ts;
+     clock_gettime(CLOCK_MONOTONIC, &ts);
+     return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+ }
+ 
+ /**
+  * @brief Largest chunk claim_chunk() hands out for a population of @p n and @p workers.
+  */
+ static inline int max_chunk(int n, int workers)
+ {
+     int chunk = n / (2 * workers);
+     return chunk > 0 ? chunk : 1;
+ }
+ 
+ /**
+  * @brief Claims the next chunk of g_eval_pop (guided scheduling).
+  *
+  * Each chunk is half the remaining work divided by the worker count, so chunks start
+  * large (few cursor updates) and shrink to single chromosomes near the end, where a
+  * worker stuck on an expensive chromosome would otherwise keep the others waiting.
+  *
+  * @param workers Number of evaluation workers.
+  * @param[out] first First index of the chunk (inclusive).
+  * @param[out] last  Last index of the chunk (exclusive).
+  * @return Non-zero if a chunk was claimed, 0 once the population is exhausted.
+  */
+ static int claim_chunk(int workers, int *first, int *last)
+ {
+     int n   = g_eval_count;
+     int cur = atomic_load_explicit(&g_eval_next, memory_order_relaxed);
+     while (cur < n) {
+         int chunk = (n - cur) / (2 * workers);
+         if (chunk < 1) chunk = 1;
+         if (atomic_compare_exchange_weak_explicit(&g_eval_next, &cur, cur + chunk,
+                                                   memory_order_relaxed, memory_order_relaxed)) {
+             *first = cur;
+             *last  = cur + chunk;
+             return 1;
+         }
+     }
+     return 0;
+ }
+ 
+ /**
+  * @brief Records the fitness of an evaluated chromosome and marks it clean.
+  *
+  * @param t   Task of the calling worker.
+  * @param c   Evaluated chromosome.
+  * @param key Genome key of @p c (only used with a fitness cache).
+  * @param f   Fitness computed for @p c.
+  */
+ static void finish_eval(FitTask *t, Chromosome *c, const GAFitnessKey *key, double f)
+ {
+     if (t->fcache) ga_fitness_cache_store(t->fcache, key, f);
+     c->fitness = f;
+     c->dirty   = 0;
+     c->parent  = NULL;  /* Parent may be freed once this generation ends. */
+ }
+ 
+ /**
+  * @brief Settles a chromosome without evaluating it when possible.
+  *
+  * Clean chromosomes keep their fitness. Dirty ones first go through the optional
+  * ctx->optimize_func step, then take the fitness the cache holds for their genome.
+  *
+  * @param t   Task of the calling worker.
+  * @param c   Chromosome of the worker's slice.
+  * @param[out] key Genome key of @p c, for finish_eval() (set with a fitness cache).
+  * @return Non-zero if @p c must be evaluated.
+  */
+ static int prepare_eval(FitTask *t, Chromosome *c, GAFitnessKey *key)
+ {
+     GAContext *ctx = t->ctx;
+     *key = (GAFitnessKey){ 0, 0 };
+     if (!c->dirty) {
+         t->skipped++;
+         c->parent = NULL;
+         return 0;
+     }
+     if (ctx->optimize_func) ctx->optimize_func(c, ctx->fitness_data, &t->eval);
+     if (t->fcache) {
+         double f;
+         key->hash  = chromosome_hash(c);
+         key->check = chromosome_check_hash(c);
+         t->cache_lookups++;
+         if (ga_fitness_cache_lookup(t->fcache, key, &f)) {
+             t->cache_hits++;
+             c->fitness = f;
+             c->dirty   = 0;
+             c->parent  = NULL;
+             return 0;
+         }
+     }
+     return 1;
+ }
+ 
+ /**
+  * @brief Updates the .fitness of each dirty Chromosome of pop[first..last)
+  *        by calling ctx->batch_fitness_func once, or ctx->fitness_func per chromosome.
+  *
+  * Chromosomes are rendered into the worker's own scratch canvas (FitTask.eval), after
+  * the optional ctx->optimize_func step and a fitness cache lookup on each of them.
+  * The fitness of every slot of the chunk, evaluated or not, is then stored in @p fit.
+  *
+  * @param t     Task of the calling worker.
+  * @param pop   Population the chunk belongs to.
+  * @param fit   Fitness array of @p pop (same indices).
+  * @param first First index of the chunk (inclusive).
+  * @param last  Last index of the chunk (exclusive).
+  */
+ static void eval_chunk(FitTask *t, Chromosome *volatile *pop, double *fit, int first, int last)
+ {
+     GAContext *ctx = t->ctx;
+ 
+     if (t->batch && t->batch_fitness) {
+         /* Whole chunk in one call; only chromosomes that still need a score are passed on. */
+         size_t n = 0;
+         for (int i = first; i < last; i++) {
+             Chromosome *c = pop[i];
+             GAFitnessKey key;
+             if (!c || !prepare_eval(t, c, &key)) continue;
+             if (t->batch_keys) t->batch_keys[n] = key;
+             t->batch[n++] = c;
+         }
+         if (n > 0) {
+             ctx->batch_fitness_func(t->batch, t->batch_fitness, n, ctx->fitness_data, &t->eval);
+         }
+         for (size_t k = 0; k < n; k++) {
+             finish_eval(t, (Chromosome*)t->batch[k], t->batch_keys ? &t->batch_keys[k] : NULL,
+                         t->batch_fitness[k]);
+         }
+         for (int i = first; i < last; i++) {
+             if (pop[i]) fit[i] = pop[i]->fitness; /* Still cache-hot from the passes above. */
+         }
+     } else {
+         for (int i = first; i < last; i++) {
+             Chromosome *c = pop[i];        /* Local pointer to the i-th chromosome. */
+             GAFitnessKey key;
+             if (!c) continue;              /* Safety guard if pointer is invalid. */
+             if (prepare_eval(t, c, &key)) {
+                 finish_eval(t, c, &key, ctx->fitness_func(c, ctx->fitness_data, &t->eval));
+             }
+             fit[i] = c->fitness;
+         }
+     }
+ }
+ 
+ /**
+  * @brief Index of the island of g_isl holding population slot @p i (binary search).
+  */
+ static int island_of(int i)
+ {
+     int lo = 0, hi = g_islands - 1;
+     while (lo < hi) {
+         int mid = (lo + hi + 1) / 2;
+         if (g_isl[mid].start <= i) lo = mid; else hi = mid - 1;
+     }
+     return lo;
+ }
+ 
+ /**
+  * @brief Fills g_eval_pop[first..last) according to g_phase, before its evaluation.
+  *
+  * The chromosomes are already in place (taken from the GA thread's pool), so workers
+  * never allocate. Each slot draws from its own random stream, numbered after the phase and the slot,
+  * so a run only depends on GAParams.seed and not on which worker claims which chunk.
+  *
+  * @param ctx   GA context.
+  * @param first First slot of the chunk (inclusive).
+  * @param last  Last slot of the chunk (exclusive).
+  */
+ static void fill_chunk(GAContext *ctx, int first, int last)
+ {
+     GARandom rng;
+     if (g_phase == GA_PHASE_INIT) {
+         for (int i = first; i < last; i++) {
+             ga_random_seed(&rng, ctx->params->seed, (g_phase_id << 32) | (uint64_t)i);
+             random_init_chrom(g_eval_pop[i], &rng);
+         }
+     } else if (g_phase == GA_PHASE_BREED) {
+         int k = island_of(first);
+         for (int i = first; i < last; i++) {
+             while (i > g_isl[k].end) k++;
+             if (g_eval_pop[i] == g_parents[i]) continue; /* Survivor, e.g. an elite. */
+             ga_random_seed(&rng, ctx->params->seed, (g_phase_id << 32) | (uint64_t)i);
+             breed_child(ctx, g_parents, g_parent_fit, g_isl[k].start, g_isl[k].end, g_eval_pop[i],
+                         &rng);
+         }
+     }
+ }
+ 
+ /**
+  * @brief Worker thread function filling and evaluating chunks of g_eval_pop until none is left.
   *
   * The thread runs in a loop:
   *   - Waits for the "start" barrier.
-  *   - Checks if the GA is still running. If not, it exits.
-  *   - If running, calculates fitness for the assigned slice of the population.
+  *   - Leaves if the phase is GA_PHASE_STOP.
+  *   - Otherwise claims chunks with claim_chunk(), randomizes or breeds their chromosomes
+  *     (fill_chunk()) and evaluates them (eval_chunk()), accumulating the time spent
+  *     in FitTask.busy_ns.
   *   - Waits for the "done" barrier.
-  *   - Breaks out if the GA has stopped.
   *
-  * @param arg Pointer to a FitTask struct that defines the slice of population and the context.
+  * @param arg Pointer to a FitTask struct holding the worker's context and buffers.
   * @return Always returns NULL.
   */
  static void *fit_worker(void *arg)
@@ -95,23 +358,25 @@
          /* Wait for "start" barrier before computing fitness. */
          pthread_barrier_wait(t->bar);
  
-         /* Check if GA has been signaled to stop or if no valid fitness function is present. */
-         if (!ctx->running || !ctx->fitness_func) {
-             pthread_barrier_wait(t->bar);
-             break;
-         }
-         if (ctx->running && (0 == *ctx->running)) {
+         /* The GA thread decides when to stop, so that no phase is ever half done. */
+         if (g_phase == GA_PHASE_STOP) {
              pthread_barrier_wait(t->bar);
              break;
          }
  
-         /* Evaluate fitness for the assigned slice of population. */
-         for (int i = t->first; i < t->last; i++) {
-             Chromosome *c = g_eval_pop[i]; /* Local pointer to the i-th chromosome. */
-             if (!c) continue;              /* Safety guard if pointer is invalid. */
-             double f = ctx->fitness_func(c, ctx->fitness_data);
-             c->fitness = f;
+         /* Fill and evaluate chunks until the population is exhausted. */
+         unsigned long long t0 = now_ns();
+         int first, last;
+         while (claim_chunk(t->eval.worker_count, &first, &last)) {
+             fill_chunk(ctx, first, last);
+             if (ctx->fitness_func || t->batch) {
+                 eval_chunk(t, g_eval_pop, g_eval_fit, first, last);
+             } else {
+                 for (int i = first; i < last; i++) g_eval_fit[i] = g_eval_pop[i]->fitness;
+             }
+             t->chunks++;
          }
+         t->busy_ns += now_ns() - t0;
  
          /* Wait for "done" barrier (main thread collects after fitness calculations). */
          pthread_barrier_wait(t->bar);
@@ -120,103 +385,199 @@
  }
  
  /**
-  * @brief Island range structure indicating the start and end indices for each island.
+  * @brief Allocates a GA_CACHE_LINE-aligned buffer (worker scratch area, fitness array).
   *
-  * Each island receives a contiguous slice [start..end] of the population array.
+  * The size is rounded up to a whole number of cache lines, as required by
+  * aligned_alloc() and so that the end of one buffer never shares
+  * a cache line with another allocation.
+  *
+  * @param size Requested size in bytes (0 yields NULL).
+  * @return Pointer to the zeroed scratch area, or NULL on failure / zero size.
   */
- typedef struct {
-     int start; /**< Start index of the slice (inclusive). */
-     int end;   /**< End index of the slice (inclusive). */
- } IslandRange;
+ static void *alloc_cache_aligned(size_t size)
+ {
+     if (size == 0) return NULL;
+     size_t rounded = (size + GA_CACHE_LINE - 1) & ~(size_t)(GA_CACHE_LINE - 1);
+     void *mem = aligned_alloc(GA_CACHE_LINE, rounded);
+     if (mem) memset(mem, 0, rounded);
+     return mem;
+ }
  
  /**
-  * @brief Finds the Chromosome with the lowest fitness in the given index range.
+  * @brief Prepares the FitTask of one evaluation thread (scratch canvas, batch buffers).
   *
-  * This function iterates over the specified range of the population array and finds the
-  * chromosome with the lowest fitness value.
+  * A missing scratch area is fatal, since every evaluation would fail and the GA would
+  * run on a meaningless fitness landscape: nothing is allocated and -1 is returned.
+  * Missing batch buffers only make the thread fall back to ctx->fitness_func.
   *
-  * @param pop   Array of Chromosome pointers.
-  * @param start Starting index (inclusive).
-  * @param end   Ending index (inclusive).
-  * @return Pointer to the best Chromosome (lowest fitness) in the specified range.
+  * @param t      Task to initialize (zeroed by the caller).
+  * @param ctx    GA context.
+  * @param bar    Barrier of the synchronous workers, or NULL.
+  * @param id     Index of the thread among @p count.
+  * @param count  Number of evaluation threads.
+  * @param cap    Largest number of chromosomes evaluated in one eval_chunk() call.
+  * @param fcache Shared fitness cache, or NULL.
+  * @return 0 on success, -1 if the scratch area could not be allocated.
   */
- static Chromosome* find_best(Chromosome **pop, int start, int end)
+ static int init_fit_task(FitTask *t, GAContext *ctx, pthread_barrier_t *bar, int id, int count,
+                          size_t cap, GAFitnessCache *fcache)
  {
-     Chromosome *best = pop[start]; /* Tracks the best chromosome found so far. */
-     for (int i = start + 1; i <= end; i++) {
-         if (pop[i]->fitness < best->fitness) {
-             best = pop[i];
+     t->ctx  = ctx;
+     t->bar  = bar;
+     t->eval.worker_id    = id;
+     t->eval.worker_count = count;
+     t->eval.scratch      = alloc_cache_aligned(ctx->eval_scratch_size);
+     t->eval.scratch_size = t->eval.scratch ? ctx->eval_scratch_size : 0;
+     if (ctx->eval_scratch_size && !t->eval.scratch) {
+         fprintf(stderr, "[GA] Out of memory for worker %d scratch.\n", id);
+         return -1;
+     }
+     t->fcache        = fcache;
+     t->skipped       = 0;
+     t->cache_lookups = 0;
+     t->cache_hits    = 0;
+     t->busy_ns       = 0;
+     t->chunks        = 0;
+     t->batch         = NULL;
+     t->batch_fitness = NULL;
+     t->batch_keys    = NULL;
+     if (ctx->batch_fitness_func) {
+         t->batch         = (const Chromosome**)malloc(cap * sizeof(Chromosome*));
+         t->batch_fitness = (double*)malloc(cap * sizeof(double));
+         if (fcache) {
+             t->batch_keys = (GAFitnessKey*)malloc(cap * sizeof(GAFitnessKey));
+         }
+         if (!t->batch || !t->batch_fitness || (fcache && !t->batch_keys)) {
+             /* Fall back to per-item evaluation for this worker. */
+             fprintf(stderr, "[GA] Out of memory for worker %d batch, using fitness_func.\n", id);
+             free(t->batch);
+             free(t->batch_fitness);
+             free(t->batch_keys);
+             t->batch         = NULL;
+             t->batch_fitness = NULL;
+             t->batch_keys    = NULL;
          }
      }
-     return best;
+     return 0;
  }
  
  /**
-  * @brief Finds the index of the Chromosome with the highest fitness in [start..end].
-  *
-  * This function iterates over the specified range of the population array and finds the
-  * index of the chromosome with the highest fitness value.
-  *
-  * @param pop   Array of Chromosome pointers.
-  * @param start Starting index (inclusive).
-  * @param end   Ending index (inclusive).
-  * @return Index of the worst Chromosome (highest fitness) in the specified range.
+  * @brief Frees the buffers allocated by init_fit_task().
   */
- static int find_worst_index(Chromosome **pop, int start, int end)
+ static void release_fit_task(FitTask *t)
  {
-     int worst = start; /* Tracks the index of the worst chromosome so far. */
-     for (int i = start + 1; i <= end; i++) {
-         if (pop[i]->fitness > pop[worst]->fitness) {
-             worst = i;
-         }
+     free(t->eval.scratch);
+     free(t->batch);
+     free(t->batch_fitness);
+     free(t->batch_keys);
+ }
+ 
+ /**
+  * @brief Fitness of one population slot, so that an island is ranked without touching
+  *        its chromosomes.
+  */
+ typedef struct {
+     double fitness; /**< Fitness of the slot. */
+     int    slot;    /**< Index of the slot in the population. */
+ } FitRank;
+ 
+ /**
+  * @brief qsort() comparator ordering FitRank entries by increasing fitness (best first).
+  */
+ static int compare_fitness(const void *a, const void *b)
+ {
+     double fa = ((const FitRank *)a)->fitness;
+     double fb = ((const FitRank *)b)->fitness;
+     return (fa > fb) - (fa < fb);
+ }
+ 
+ /**
+  * @brief Fills order[0..end-start] with the slots of fit[start..end], best first.
+  */
+ static void rank_island(const double *fit, int start, int end, FitRank *order)
+ {
+     int size = end - start + 1;
+     for (int i = 0; i < size; i++) {
+         order[i].fitness = fit[start + i];
+         order[i].slot    = start + i;
      }
-     return worst;
+     qsort(order, (size_t)size, sizeof(FitRank), compare_fitness);
+ }
+ 
+ /**
+  * @brief Splits [0..n) into @p parts contiguous ranges whose sizes differ by at most one.
+  *
+  * @param n     Number of items (population size).
+  * @param parts Number of ranges, in [1..n].
+  * @param k     Index of the requested range.
+  * @return Range number @p k, [start..end] inclusive.
+  */
+ static IslandRange split_range(int n, int parts, int k)
+ {
+     IslandRange r;
+     r.start = (int)((long long)n * k / parts);
+     r.end   = (int)((long long)n * (k + 1) / parts) - 1;
+     return r;
  }
  
  /**
   * @brief Performs a tournament selection within [a..b] by picking two random individuals
   *        and returning the one with lower fitness.
   *
-  * This function selects two random chromosomes within the specified range and returns
-  * the chromosome with the lower fitness value.
+  * This function selects two random slots within the specified range and compares their
+  * fitness in the population's fitness array, without dereferencing any chromosome.
   *
-  * @param arr Array of Chromosome pointers.
+  * @param fit Fitness array of the population.
   * @param a   Starting index (inclusive).
   * @param b   Ending index (inclusive).
-  * @return Pointer to the Chromosome that wins the tournament (lower fitness).
+  * @param rng Random stream of the caller.
+  * @return Index of the slot that wins the tournament (lower fitness).
   */
- static inline Chromosome* tournament_in_range(Chromosome **arr, int a, int b)
+ static inline int tournament_in_range(const double *fit, int a, int b, GARandom *rng)
  {
-     int idx1 = a + rand() % (b - a + 1); /* First random index in range. */
-     int idx2 = a + rand() % (b - a + 1); /* Second random index in range. */
- 
-     Chromosome *c1 = arr[idx1];         /* First randomly chosen Chromosome. */
-     Chromosome *c2 = arr[idx2];         /* Second randomly chosen Chromosome. */
-     return (c1->fitness <= c2->fitness) ? c1 : c2;
+     int idx1 = a + (int)ga_random_below(rng, (uint32_t)(b - a + 1)); /* First random index in range. */
+     int idx2 = a + (int)ga_random_below(rng, (uint32_t)(b - a + 1)); /* Second random index in range. */
+     return (fit[idx1] <= fit[idx2]) ? idx1 : idx2;
  }
  
  /**
   * @brief Migrates top-performing Chromosomes among islands in a ring topology.
   *
-  * This function copies the best individual from each island into the worst slot of the next island.
-  * The migration follows a ring topology, where the last island migrates to the first island.
+  * This function copies the @p migrants best individuals of each island over the worst ones
+  * of the next island; the last island migrates to the first island. At most half of an
+  * island is exchanged, so that the slots overwritten never hold outgoing migrants.
   *
-  * @param isl Array of IslandRange structs defining each island's slice in the population.
-  * @param pop Array of Chromosome pointers (entire population).
+  * @param isl      Array of IslandRange structs defining each island's slice in the population.
+  * @param islands  Number of islands.
+  * @param migrants Number of individuals sent by each island.
+  * @param pop      Array of Chromosome pointers (entire population).
+  * @param fit      Fitness array of @p pop, updated for the overwritten slots.
+  * @param order    Scratch array of the population size.
   */
- static void migrate(IslandRange isl[], Chromosome **pop)
+ static void migrate(const IslandRange isl[], int islands, int migrants, Chromosome **pop,
+                     double *fit, FitRank *order)
  {
-     Chromosome *migrants[ISLAND_COUNT]; /**< Temporary array of best Chromosomes from each island. */
-     for (int i = 0; i < ISLAND_COUNT; i++) {
-         migrants[i] = find_best(pop, isl[i].start, isl[i].end);
+     /* Rank every island: order[start..end] goes from its best to its worst member. */
+     int m = migrants;
+     for (int i = 0; i < islands; i++) {
+         int size = isl[i].end - isl[i].start + 1;
+         rank_island(fit, isl[i].start, isl[i].end, &order[isl[i].start]);
+         if (m > size / 2) m = size / 2;
      }
  
-     /* Place them into the "next" island’s worst slot (ring). */
-     for (int dest = 0; dest < ISLAND_COUNT; dest++) {
-         int src = (dest - 1 + ISLAND_COUNT) % ISLAND_COUNT; /* Ring-based source index. */
-         int widx = find_worst_index(pop, isl[dest].start, isl[dest].end);
-         copy_chromosome(pop[widx], migrants[src]);
-         pop[widx]->fitness = migrants[src]->fitness;
+     /* Place the best of each island into the "next" island's worst slots (ring). */
+     for (int dest = 0; dest < islands; dest++) {
+         int src = (dest - 1 + islands) % islands; /* Ring-based source index. */
+         for (int j = 0; j < m; j++) {
+             int from_slot          = order[isl[src].start + j].slot;
+             int to_slot            = order[isl[dest].end - j].slot;
+             const Chromosome *from = pop[from_slot];
+             Chromosome *to         = pop[to_slot];
+             copy_chromosome(to, from);
+             to->fitness  = from->fitness;
+             to->dirty    = from->dirty;
+             fit[to_slot] = fit[from_slot];
+         }
      }
  }
  
@@ -224,32 +585,33 @@
   * @brief Creates a random Gene (either a circle or a triangle) with random position and color.
   *
   * This function does not perform any pixel-based logic. It simply assigns random geometry
-  * (circle or triangle) and random RGBA color values.
+  * (circle or triangle) and random RGBA color values. The gene is zero-initialized first,
+  * so the union bytes a circle leaves unused never hold garbage (genes are compared bytewise).
   *
+  * @param rng Random stream of the caller.
   * @return A randomly initialized Gene.
   */
- static Gene random_gene(void)
+ static Gene random_gene(GARandom *rng)
  {
-     Gene g; /* A new gene with random geometry and color. */
-     if (rand() & 1) {
-         g.type = SHAPE_CIRCLE;
-         g.geom.circle.cx     = rand() % 640;
-         g.geom.circle.cy     = rand() % 480;
-         g.geom.circle.radius = (rand() % 50) + 1;
+     Gene g = {0}; /* A new gene with random geometry and color. */
+     if (ga_random_next(rng) >> 63) {
+         g.geom.circle.tag    = GENE_CIRCLE_TAG;
+         g.geom.circle.cx     = (int16_t)ga_random_below(rng, 640);
+         g.geom.circle.cy     = (int16_t)ga_random_below(rng, 480);
+         g.geom.circle.radius = (int16_t)(ga_random_below(rng, 50) + 1);
      } else {
-         g.type = SHAPE_TRIANGLE;
-         g.geom.triangle.x1 = rand() % 640;
-         g.geom.triangle.y1 = rand() % 480;
-         g.geom.triangle.x2 = rand() % 640;
-         g.geom.triangle.y2 = rand() % 480;
-         g.geom.triangle.x3 = rand() % 640;
-         g.geom.triangle.y3 = rand() % 480;
+         g.geom.triangle.x1 = (int16_t)ga_random_below(rng, 640);
+         g.geom.triangle.y1 = (int16_t)ga_random_below(rng, 480);
+         g.geom.triangle.x2 = (int16_t)ga_random_below(rng, 640);
+         g.geom.triangle.y2 = (int16_t)ga_random_below(rng, 480);
+         g.geom.triangle.x3 = (int16_t)ga_random_below(rng, 640);
+         g.geom.triangle.y3 = (int16_t)ga_random_below(rng, 480);
      }
  
-     g.r = (unsigned char)(rand() % 256);
-     g.g = (unsigned char)(rand() % 256);
-     g.b = (unsigned char)(rand() % 256);
-     g.a = (unsigned char)(rand() % 256);
+     g.r = (unsigned char)ga_random_below(rng, 256);
+     g.g = (unsigned char)ga_random_below(rng, 256);
+     g.b = (unsigned char)ga_random_below(rng, 256);
+     g.a = (unsigned char)ga_random_below(rng, 256);
  
      return g;
  }
@@ -260,14 +622,16 @@
   * This function initializes each gene in the chromosome with random values using the `random_gene` function.
   * It also sets the fitness to a very large number, indicating an uncomputed state.
   *
-  * @param c Pointer to the Chromosome to be randomized.
+  * @param c   Pointer to the Chromosome to be randomized.
+  * @param rng Random stream of the caller.
   */
- static void random_init_chrom(Chromosome *c)
+ static void random_init_chrom(Chromosome *c, GARandom *rng)
  {
      for (size_t i = 0; i < c->n_shapes; i++) {
-         c->shapes[i] = random_gene();
+         c->shapes[i] = random_gene(rng);
      }
      c->fitness = 1.0e30; /* Initialize fitness to a very large number. */
+     c->dirty   = 1;
  }
  
  /**
@@ -276,66 +640,67 @@
   * Depending on a random choice, it may replace the gene entirely
   * with a new random gene or mutate one of its parameters (geometry or color).
   *
-  * @param g Pointer to the Gene being mutated.
+  * @param g   Pointer to the Gene being mutated.
+  * @param rng Random stream of the caller.
   */
- static void mutate_gene(Gene *g)
+ static void mutate_gene(Gene *g, GARandom *rng)
  {
-     switch (rand() % 9) {
+     switch (ga_random_below(rng, 9)) {
      case 0:
          /* Replace entire gene with a newly generated random gene. */
-         *g = random_gene();
+         *g = random_gene(rng);
          break;
      case 1:
          /* Mutate circle.x or triangle.x1. */
-         if (g->type == SHAPE_CIRCLE) {
-             g->geom.circle.cx = rand() % 640;
+         if (gene_type(g) == SHAPE_CIRCLE) {
+             g->geom.circle.cx = (int16_t)ga_random_below(rng, 640);
          } else {
-             g->geom.triangle.x1 = rand() % 640;
+             g->geom.triangle.x1 = (int16_t)ga_random_below(rng, 640);
          }
          break;
      case 2:
          /* Mutate circle.y or triangle.y1. */
-         if (g->type == SHAPE_CIRCLE) {
-             g->geom.circle.cy = rand() % 480;
+         if (gene_type(g) == SHAPE_CIRCLE) {
+             g->geom.circle.cy = (int16_t)ga_random_below(rng, 480);
          } else {
-             g->geom.triangle.y1 = rand() % 480;
+             g->geom.triangle.y1 = (int16_t)ga_random_below(rng, 480);
          }
          break;
      case 3:
          /* Mutate circle radius or triangle.x2. */
-         if (g->type == SHAPE_CIRCLE) {
-             g->geom.circle.radius = (rand() % 50) + 1;
+         if (gene_type(g) == SHAPE_CIRCLE) {
+             g->geom.circle.radius = (int16_t)(ga_random_below(rng, 50) + 1);
          } else {
-             g->geom.triangle.x2 = rand() % 640;
+             g->geom.triangle.x2 = (int16_t)ga_random_below(rng, 640);
          }
          break;
      case 4:
          /* Mutate triangle.y2 if shape is triangle. */
-         if (g->type == SHAPE_TRIANGLE) {
-             g->geom.triangle.y2 = rand() % 480;
+         if (gene_type(g) == SHAPE_TRIANGLE) {
+             g->geom.triangle.y2 = (int16_t)ga_random_below(rng, 480);
          }
          break;
      case 5:
          /* Mutate triangle.x3 if shape is triangle. */
-         if (g->type == SHAPE_TRIANGLE) {
-             g->geom.triangle.x3 = rand() % 640;
+         if (gene_type(g) == SHAPE_TRIANGLE) {
+             g->geom.triangle.x3 = (int16_t)ga_random_below(rng, 640);
          }
          break;
      case 6:
          /* Mutate triangle.y3 if shape is triangle. */
-         if (g->type == SHAPE_TRIANGLE) {
-             g->geom.triangle.y3 = rand() % 480;
+         if (gene_type(g) == SHAPE_TRIANGLE) {
+             g->geom.triangle.y3 = (int16_t)ga_random_below(rng, 480);
          }
          break;
      case 7:
          /* Mutate color (r,g,b). */
-         g->r = (unsigned char)(rand() % 256);
-         g->g = (unsigned char)(rand() % 256);
-         g->b = (unsigned char)(rand() % 256);
+         g->r = (unsigned char)ga_random_below(rng, 256);
+         g->g = (unsigned char)ga_random_below(rng, 256);
+         g->b = (unsigned char)ga_random_below(rng, 256);
          break;
      case 8:
          /* Mutate alpha channel. */
-         g->a = (unsigned char)(rand() % 256);
+         g->a = (unsigned char)ga_random_below(rng, 256);
          break;
      }
  }
@@ -360,6 +725,590 @@
      memcpy(o->shapes + cut, b->shapes + cut, (o->n_shapes - cut) * sizeof(Gene));
  }
  
+ /**
+  * @brief Copies @p best into ctx->best_snapshot under ctx->best_mutex, if both exist.
+  *
+  * When ctx->exact_fitness_func is set, the published fitness is re-computed with it
+  * (on the GA thread, using @p eval) instead of copying the possibly estimated score.
+  *
+  * @param ctx  GA context.
+  * @param best Chromosome to publish (already evaluated).
+  * @param eval Evaluation context of the GA thread.
+  */
+ static void publish_best(GAContext *ctx, const Chromosome *best, const GAEvalContext *eval)
+ {
+     if (ctx->best_snapshot && ctx->best_mutex) {
+         double f = best->fitness;
+         if (ctx->exact_fitness_func) {
+             f = ctx->exact_fitness_func(best, ctx->fitness_data, eval);
+         }
+         pthread_mutex_lock(ctx->best_mutex);
+         copy_chromosome(ctx->best_snapshot, best);
+         ctx->best_snapshot->fitness = f;
+         pthread_mutex_unlock(ctx->best_mutex);
+     }
+ }
+ 
+ /**
+  * @brief Publishes @p c as ctx->best_snapshot if it beats the current snapshot.
+  *
+  * Used by the asynchronous islands, which compete for the snapshot; the comparison
+  * and the copy happen under ctx->best_mutex.
+  *
+  * @param ctx  GA context.
+  * @param c    Chromosome to publish (already evaluated).
+  * @param eval Evaluation context of the calling thread (for ctx->exact_fitness_func).
+  */
+ static void publish_if_better(GAContext *ctx, const Chromosome *c, const GAEvalContext *eval)
+ {
+     if (!ctx->best_snapshot || !ctx->best_mutex) return;
+     double f = c->fitness;
+     if (ctx->exact_fitness_func) {
+         f = ctx->exact_fitness_func(c, ctx->fitness_data, eval);
+     }
+     pthread_mutex_lock(ctx->best_mutex);
+     if (f < ctx->best_snapshot->fitness) {
+         copy_chromosome(ctx->best_snapshot, c);
+         ctx->best_snapshot->fitness = f;
+     }
+     pthread_mutex_unlock(ctx->best_mutex);
+ }
+ 
+ /**
+  * @brief Exchanges slots @p i and @p j of a population and of its fitness array.
+  */
+ static inline void swap_slots(Chromosome **pop, double *fit, int i, int j)
+ {
+     Chromosome *c = pop[i];
+     pop[i] = pop[j];
+     pop[j] = c;
+     double f = fit[i];
+     fit[i] = fit[j];
+     fit[j] = f;
+ }
+ 
+ /**
+  * @brief Moves the @p elites best chromosomes of pop[start..end] to its first slots,
+  *        the very best to pop[start].
+  *
+  * A quickselect (Hoare partition around a median-of-three pivot) reorders the island's
+  * pointers in place in O(n), without sorting the rest. Comparisons read @p fit, whose
+  * entries move along with their chromosomes. The elites then survive in their
+  * own slots, which lets assign_children() and free_old_island() treat every slot
+  * independently.
+  *
+  * @param pop    Population.
+  * @param fit    Fitness array of @p pop.
+  * @param start  First index of the island (inclusive).
+  * @param end    Last index of the island (inclusive).
+  * @param elites Number of elites wanted (at least 1).
+  * @return Number of elites in front, @p elites capped at the island size.
+  */
+ static int promote_elites(Chromosome **pop, double *fit, int start, int end, int elites)
+ {
+     int k = elites < end - start + 1 ? elites : end - start + 1;
+     int target = start + k - 1; /* Last elite slot: fit[start..target] <= fit[target + 1..end]. */
+     int lo = start, hi = end;
+     while (lo < hi) {
+         int mid = lo + (hi - lo) / 2;
+         if (fit[mid] < fit[lo]) swap_slots(pop, fit, mid, lo);
+         if (fit[hi]  < fit[lo]) swap_slots(pop, fit, hi, lo);
+         if (fit[hi]  < fit[mid]) swap_slots(pop, fit, hi, mid);
+         double pivot = fit[mid];
+ 
+         int i = lo, j = hi;
+         while (i <= j) {
+             while (fit[i] < pivot) i++;
+             while (fit[j] > pivot) j--;
+             if (i <= j) {
+                 swap_slots(pop, fit, i, j);
+                 i++;
+                 j--;
+             }
+         }
+         /* fit[lo..j] <= pivot <= fit[i..hi], and slots in between equal the pivot. */
+         if (target <= j) hi = j;
+         else if (target >= i) lo = i;
+         else break;
+     }
+ 
+     /* The best of the elites goes first. */
+     swap_slots(pop, fit, start, ga_fitness_argmin(fit, start, target));
+     return k;
+ }
+ 
+ /**
+  * @brief Breeds a child of the island pop[start..end] into @p child.
+  *
+  * The child of two tournament winners (crossover, then mutation) keeps a parent link
+  * for incremental evaluation and is marked dirty unless it is an exact copy of an
+  * evaluated parent. Children only read @p pop and @p fit, so they can be bred concurrently.
+  *
+  * @param ctx   GA context (parameters).
+  * @param pop   Current population of the island.
+  * @param fit   Fitness array of @p pop.
+  * @param start First index of the island (inclusive).
+  * @param end   Last index of the island (inclusive).
+  * @param child Chromosome to overwrite, freshly acquired (not in @p pop).
+  * @param rng   Random stream used for this child.
+  */
+ static void breed_child(GAContext *ctx, Chromosome **pop, const double *fit, int start, int end,
+                         Chromosome *child, GARandom *rng)
+ {
+     const GAParams *p = ctx->params;
+     int ia = tournament_in_range(fit, start, end, rng);
+     int ib = tournament_in_range(fit, start, end, rng);
+ 
+     /* Ensure pa is not worse than pb for consistent crossover. */
+     if (fit[ib] < fit[ia]) {
+         int tmp = ia;
+         ia = ib;
+         ib = tmp;
+     }
+     Chromosome *pa = pop[ia];
+     Chromosome *pb = pop[ib];
+ 
+     /* Children mostly differ from pa in a few genes: let the fitness
+      * function re-score only the area they changed. */
+     child->parent         = pa;
+     child->parent_fitness = fit[ia];
+ 
+     int changed = 0; /* Set once the child's genes may differ from pa's. */
+     float r01 = ga_random_float(rng); /* Random [0..1) for crossover test. */
+     if (r01 < p->crossover_rate) {
+         crossover(pa, pb, child);
+         changed = (pa != pb);
+     } else {
+         /* No crossover => copy parent pa. */
+         memcpy(child->shapes, pa->shapes, pa->n_shapes * sizeof(Gene));
+     }
+ 
+     /* Mutation step. */
+     for (size_t g = 0; g < child->n_shapes; g++) {
+         float mr = ga_random_float(rng); /* Random [0..1) for mutation test. */
+         if (mr < p->mutation_rate) {
+             mutate_gene(&child->shapes[g], rng);
+             changed = 1;
+         }
+     }
+ 
+     /* An exact copy of pa keeps its score and skips evaluation. */
+     if (!changed && !pa->dirty) {
+         child->fitness = fit[ia];
+         child->dirty   = 0;
+         child->parent  = NULL;
+     }
+ }
+ 
+ /**
+  * @brief Sets up new_pop[start..end] for breeding the island pop[start..end].
+  *
+  * The island's elites are moved to its first slots and survive there, evaluated and
+  * without copying their genes; every other slot receives a chromosome from @p pool,
+  * to be overwritten by breed_child(). A slot keeps its parent pop[i] for one more
+  * generation if the pool is exhausted (it is sized so that this never happens).
+  *
+  * @param pool    Pool of the island's chromosomes.
+  * @param pop     Current population (its elites are moved to its first slots).
+  * @param fit     Fitness array of @p pop (reordered along with it).
+  * @param new_pop Next population.
+  * @param start   First index of the island (inclusive).
+  * @param end     Last index of the island (inclusive).
+  * @param elites  Number of elites kept (at least 1).
+  */
+ static void assign_children(GAChromosomePool *pool, Chromosome **pop, double *fit,
+                             Chromosome **new_pop, int start, int end, int elites)
+ {
+     int k = promote_elites(pop, fit, start, end, elites);
+     for (int i = start; i < start + k; i++) {
+         new_pop[i] = pop[i];
+     }
+     for (int i = start + k; i <= end; i++) {
+         Chromosome *c = ga_chromosome_pool_acquire(pool);
+         new_pop[i] = c ? c : pop[i];
+     }
+ }
+ 
+ /**
+  * @brief Breeds the next generation of one island, new_pop[start..end] from pop[start..end].
+  *
+  * @param ctx     GA context.
+  * @param pool    Pool of the island's chromosomes.
+  * @param pop     Current population (its elites are moved to its first slots).
+  * @param fit     Fitness array of @p pop.
+  * @param new_pop Next population.
+  * @param start   First index of the island (inclusive).
+  * @param end     Last index of the island (inclusive).
+  * @param elites  Number of elites kept (at least 1).
+  * @param rng     Random stream of the island.
+  */
+ static void breed_island(GAContext *ctx, GAChromosomePool *pool, Chromosome **pop, double *fit,
+                          Chromosome **new_pop, int start, int end, int elites, GARandom *rng)
+ {
+     assign_children(pool, pop, fit, new_pop, start, end, elites);
+     for (int i = start; i <= end; i++) {
+         if (new_pop[i] != pop[i]) {
+             breed_child(ctx, pop, fit, start, end, new_pop[i], rng);
+         }
+     }
+ }
+ 
+ /**
+  * @brief Returns the chromosomes of pop[start..end] that did not survive into new_pop
+  *        to @p pool (survivors, such as the elites, stay in their own slot).
+  */
+ static void free_old_island(GAChromosomePool *pool, Chromosome **pop, Chromosome **new_pop,
+                             int start, int end)
+ {
+     for (int i = start; i <= end; i++) {
+         if (pop[i] != new_pop[i]) {
+             ga_chromosome_pool_release(pool, pop[i]);
+         }
+     }
+ }
+ 
+ /**
+  * @brief Runs one parallel phase of the workers over @p pop and waits until it is done.
+  *
+  * Must be called by the GA thread while the workers wait on the "start" barrier.
+  *
+  * @param phase   Work to do on each slot (filled slots are then evaluated).
+  *                Every slot of @p pop must already hold a chromosome.
+  * @param parents Previous generation, for GA_PHASE_BREED (its elites first, see promote_elites()).
+  * @param parent_fit Fitness array of @p parents, for GA_PHASE_BREED.
+  * @param isl     Island ranges, for GA_PHASE_BREED.
+  * @param islands Number of islands, for GA_PHASE_BREED.
+  * @param pop     Population to fill and/or evaluate (its dirty chromosomes).
+  * @param fit     Fitness array of @p pop, filled by the workers.
+  * @param n       Population size.
+  * @param bar     Barrier shared with the evaluation workers.
+  */
+ static void run_phase(GAPhase phase, Chromosome **parents, const double *parent_fit,
+                       const IslandRange *isl, int islands, Chromosome **pop, double *fit, int n,
+                       pthread_barrier_t *bar)
+ {
+     unsigned long long t0 = now_ns();
+     g_phase      = phase;
+     g_phase_id++;
+     g_parents    = parents;
+     g_parent_fit = parent_fit;
+     g_isl        = isl;
+     g_islands    = islands;
+     g_eval_pop   = pop;
+     g_eval_fit   = fit;
+     g_eval_count = n;
+     atomic_store_explicit(&g_eval_next, 0, memory_order_relaxed);
+     pthread_barrier_wait(bar); /* start */
+     pthread_barrier_wait(bar); /* done */
+     g_eval_wall_ns += now_ns() - t0;
+ }
+ 
+ /**
+  * @brief Calls ctx->generation_func and, if it reports a new fitness landscape,
+  *        re-evaluates the population and restarts best tracking.
+  *
+  * Must be called by the GA thread while the workers wait on the "start" barrier.
+  *
+  * @param ctx       GA context.
+  * @param fcache    Fitness cache shared by the workers (may be NULL), emptied on a change.
+  * @param iteration Index of the generation that was just evaluated.
+  * @param pop       Current population.
+  * @param fit       Fitness array of @p pop, refreshed by the re-evaluation.
+  * @param n         Population size.
+  * @param[in,out] best Best chromosome so far; replaced by the re-evaluated best.
+  * @param bar       Barrier shared with the evaluation workers.
+  * @param eval      Evaluation context of the GA thread.
+  */
+ static void notify_generation(GAContext *ctx, GAFitnessCache *fcache, int iteration,
+                               Chromosome **pop, double *fit, int n, Chromosome **best,
+                               pthread_barrier_t *bar, const GAEvalContext *eval)
+ {
+     if (!ctx->generation_func || !ctx->running || *ctx->running == 0)
+         return;
+ 
+     GAGenerationInfo info = { iteration, (*best)->fitness };
+     if (!ctx->generation_func(&info, ctx->fitness_data))
+         return;
+ 
+     /* Old scores were measured against another objective: rescore everyone. */
+     for (int i = 0; i < n; i++) {
+         pop[i]->dirty = 1;
+     }
+     ga_fitness_cache_clear(fcache);
+     run_phase(GA_PHASE_EVAL, NULL, NULL, NULL, 0, pop, fit, n, bar);
+ 
+     *best = pop[ga_fitness_argmin(fit, 0, n - 1)];
+     publish_best(ctx, *best, eval);
+ 
+     char msg[96];
+     snprintf(msg, sizeof(msg), "[GA %d] fitness landscape changed, population re-evaluated (best %.4f)",
+              iteration, (*best)->fitness);
+     ga_log(ctx, GA_LOG_INFO, msg);
+ }
+ 
+ /**
+  * @brief State of one island in asynchronous mode (GAParams.async_islands).
+  *
+  * The island thread owns pop[start..end] and new_pop[start..end] of the shared arrays
+  * (and the same slices of their fitness arrays) and the pool their chromosomes come
+  * from, evaluates its own children through @p fit, receives migrants from @p inbox and
+  * sends its best chromosomes to the next island through @p outbox.
+  */
+ typedef struct IslandTask {
+     FitTask fit;           /**< Evaluation context, buffers and counters of the island thread. */
+     int start;             /**< First index of the island (inclusive). */
+     int end;               /**< Last index of the island (inclusive). */
+     int mig_every;         /**< Generations between two sendings. */
+     int elites;            /**< Elites kept by the island each generation. */
+     int migrants;          /**< Chromosomes sent each time. */
+     Chromosome **pop;      /**< Current population (shared array, island slice only). */
+     Chromosome **new_pop;  /**< Next population (shared array, island slice only). */
+     double *pop_fit;       /**< Fitness array of pop (shared array, island slice only). */
+     double *new_fit;       /**< Fitness array of new_pop (shared array, island slice only). */
+     FitRank *order;        /**< Scratch used to rank the island (island size). */
+     GAChromosomePool *pool; /**< Chromosomes of the island (two generations). */
+     GAMailbox *inbox;      /**< Migrants from the previous island (this island consumes). */
+     GAMailbox *outbox;     /**< Migrants to the next island (this island produces). */
+     GARandom rng;          /**< Random stream of the island. */
+     unsigned long long received; /**< Migrants taken in. */
+     unsigned long long dropped;  /**< Migrants not sent because the outbox was full. */
+ } IslandTask;
+ 
+ /**
+  * @brief Replaces the island's worst chromosomes with the migrants waiting in its inbox.
+  *
+  * Migrants are evaluated copies owned by the mailbox; each one is copied over a worse
+  * chromosome of the island, if any, then freed. Island chromosomes thus never leave
+  * the island's pool.
+  */
+ static void receive_migrants(IslandTask *t)
+ {
+     GAContext *ctx = t->fit.ctx;
+     Chromosome *m;
+     while ((m = (Chromosome*)ga_mailbox_pop(t->inbox)) != NULL) {
+         int w = ga_fitness_argmax(t->pop_fit, t->start, t->end);
+         if (m->fitness < t->pop_fit[w]) {
+             Chromosome *to = t->pop[w];
+             copy_chromosome(to, m);
+             to->fitness = m->fitness;
+             to->dirty   = m->dirty;
+             to->parent  = NULL;
+             t->pop_fit[w] = m->fitness;
+             t->received++;
+         }
+         ctx->free_chromosome(m);
+     }
+ }
+ 
+ /**
+  * @brief Sends copies of the island's best chromosomes to the next island.
+  *
+  * Never waits: copies that do not fit in the outbox are dropped.
+  */
+ static void send_migrants(IslandTask *t)
+ {
+     GAContext *ctx = t->fit.ctx;
+     int size = t->end - t->start + 1;
+     int m    = t->migrants < size ? t->migrants : size;
+ 
+     rank_island(t->pop_fit, t->start, t->end, t->order);
+     for (int j = 0; j < m; j++) {
+         const Chromosome *from = t->pop[t->order[j].slot];
+         Chromosome *copy = ctx->alloc_chromosome(from->n_shapes);
+         if (!copy) {
+             t->dropped++;
+             continue;
+         }
+         copy_chromosome(copy, from);
+         copy->fitness = t->order[j].fitness;
+         copy->dirty   = from->dirty;
+         copy->parent  = NULL;
+         if (!ga_mailbox_push(t->outbox, copy)) {
+             ctx->free_chromosome(copy);
+             t->dropped++;
+         }
+     }
+ }
+ 
+ /**
+  * @brief Island thread of the asynchronous mode: evolves pop[start..end] on its own.
+  *
+  * Each generation takes in the migrants received so far, sends migrants every
+  * mig_every generations, then breeds, evaluates and replaces the island's population.
+  * The thread never waits for another island and stops after GAParams.max_iterations
+  * generations or when ctx->running is cleared.
+  *
+  * @param arg Pointer to the island's IslandTask.
+  * @return Always returns NULL.
+  */
+ static void *island_worker(void *arg)
+ {
+     IslandTask *t = (IslandTask*)arg;
+     GAContext *ctx = t->fit.ctx;
+     const GAParams *p = ctx->params;
+     int id = t->fit.eval.worker_id;
+ 
+     /* Create and evaluate the island's initial population. The pool holds the current
+      * generation and the children bred from it, and is first touched by this thread. */
+     t->pool = ga_chromosome_pool_create(2 * (size_t)(t->end - t->start + 1), (size_t)p->nb_shapes);
+     if (!t->pool) {
+         fprintf(stderr, "[GA] Out of memory creating chromosomes (island %d).\n", id);
+         return NULL;
+     }
+     for (int i = t->start; i <= t->end; i++) {
+         t->pop[i] = ga_chromosome_pool_acquire(t->pool);
+         random_init_chrom(t->pop[i], &t->rng);
+     }
+     if (!ctx->fitness_func && !t->fit.batch) return NULL;
+     eval_chunk(&t->fit, t->pop, t->pop_fit, t->start, t->end + 1);
+     int b = ga_fitness_argmin(t->pop_fit, t->start, t->end);
+     double best = t->pop_fit[b];
+     publish_if_better(ctx, t->pop[b], &t->fit.eval);
+ 
+     unsigned long long prev_ns = now_ns();
+     for (int gen = 1; ctx->running && *ctx->running != 0 && gen <= p->max_iterations; gen++) {
+         receive_migrants(t);
+         if ((gen % t->mig_every) == 0) {
+             send_migrants(t);
+         }
+ 
+         breed_island(ctx, t->pool, t->pop, t->pop_fit, t->new_pop, t->start, t->end, t->elites,
+                      &t->rng);
+         unsigned long long t0 = now_ns();
+         eval_chunk(&t->fit, t->new_pop, t->new_fit, t->start, t->end + 1);
+         t->fit.busy_ns += now_ns() - t0;
+ 
+         int gen_best = ga_fitness_argmin(t->new_fit, t->start, t->end);
+         if (t->new_fit[gen_best] < best) {
+             best = t->new_fit[gen_best];
+             publish_if_better(ctx, t->new_pop[gen_best], &t->fit.eval);
+         }
+ 
+         free_old_island(t->pool, t->pop, t->new_pop, t->start, t->end);
+         memcpy(&t->pop[t->start], &t->new_pop[t->start],
+                (size_t)(t->end - t->start + 1) * sizeof(Chromosome*));
+         memcpy(&t->pop_fit[t->start], &t->new_fit[t->start],
+                (size_t)(t->end - t->start + 1) * sizeof(double));
+ 
+         /* Optionally measure performance every 100 generations of this island. */
+         if ((gen % 100) == 0) {
+             unsigned long long now = now_ns();
+             fprintf(stdout, "[GA island %d, gen %d] island best = %.4f, last 100 gens: %.0f ms "
+                             "(%.0f%% evaluating), migrants in: %llu, dropped: %llu\n",
+                     id, gen, best, (double)(now - prev_ns) / 1.0e6,
+                     now > prev_ns ? 100.0 * (double)t->fit.busy_ns / (double)(now - prev_ns) : 0.0,
+                     t->received, t->dropped);
+             prev_ns = now;
+             t->fit.busy_ns = 0;
+         }
+     }
+     return NULL;
+ }
+ 
+ /**
+  * @brief Runs the asynchronous island mode on an initialized population.
+  *
+  * One thread per island evolves its slice of @p pop independently; island i sends its
+  * migrants to island (i + 1) % islands through a single-producer / single-consumer
+  * mailbox, so islands never synchronize with each other. Returns once every island
+  * has finished; island chromosomes are released with their pools, so @p pop is
+  * cleared on return.
+  *
+  * @param ctx       GA context.
+  * @param pop       Population (all NULL; each island creates its own slice).
+  * @param new_pop   Scratch population array of the same size.
+  * @param fit       Fitness array of @p pop.
+  * @param new_fit   Fitness array of @p new_pop.
+  * @param isl       Island ranges.
+  * @param islands   Number of islands.
+  * @param mig_every Generations between two sendings of an island.
+  * @param migrants  Chromosomes sent each time.
+  * @param elites    Elites kept by each island every generation.
+  * @param fcache    Shared fitness cache, or NULL.
+  * @return 0 on success, -1 if the islands could not be set up.
+  */
+ static int run_async_islands(GAContext *ctx, Chromosome **pop, Chromosome **new_pop,
+                              double *fit, double *new_fit, const IslandRange *isl,
+                              int islands, int mig_every, int migrants, int elites,
+                              GAFitnessCache *fcache)
+ {
+     IslandTask *tasks = (IslandTask*)calloc((size_t)islands, sizeof(IslandTask));
+     GAMailbox **boxes = (GAMailbox**)calloc((size_t)islands, sizeof(GAMailbox*));
+     pthread_t *tids   = (pthread_t*)calloc((size_t)islands, sizeof(pthread_t));
+     int ok = tasks && boxes && tids;
+ 
+     /* A mailbox holds a few sendings, so a slow consumer only costs dropped migrants. */
+     for (int i = 0; ok && i < islands; i++) {
+         boxes[i] = ga_mailbox_create((size_t)migrants * 4);
+         ok = boxes[i] != NULL;
+     }
+     int started = 0;
+     for (int i = 0; ok && i < islands; i++) {
+         IslandTask *t = &tasks[i];
+         int size = isl[i].end - isl[i].start + 1;
+         if (init_fit_task(&t->fit, ctx, NULL, i, islands, (size_t)size, fcache) != 0) {
+             fprintf(stderr, "[GA] Failed to start island %d.\n", i);
+             break;
+         }
+         t->start     = isl[i].start;
+         t->end       = isl[i].end;
+         t->mig_every = mig_every;
+         t->elites    = elites;
+         t->migrants  = migrants;
+         t->pop       = pop;
+         t->new_pop   = new_pop;
+         t->pop_fit   = fit;
+         t->new_fit   = new_fit;
+         t->order     = (FitRank*)malloc((size_t)size * sizeof(FitRank));
+         t->inbox     = boxes[i];
+         t->outbox    = boxes[(i + 1) % islands];
+         ga_random_seed(&t->rng, ctx->params->seed, ~(uint64_t)i); /* Disjoint from slot streams. */
+         if (!t->order || pthread_create(&tids[i], NULL, island_worker, t) != 0) {
+             fprintf(stderr, "[GA] Failed to start island %d.\n", i);
+             release_fit_task(&t->fit);
+             free(t->order);
+             break;
+         }
+         started++;
+     }
+     if (ok && started < islands && ctx->running) {
+         *ctx->running = 0; /* Stop the islands already running. */
+     }
+ 
+     unsigned long long received = 0, dropped = 0;
+     for (int i = 0; i < started; i++) {
+         pthread_join(tids[i], NULL);
+         received += tasks[i].received;
+         dropped  += tasks[i].dropped;
+         release_fit_task(&tasks[i].fit);
+         free(tasks[i].order);
+         ga_chromosome_pool_destroy(tasks[i].pool);
+         for (int j = tasks[i].start; j <= tasks[i].end; j++) {
+             pop[j] = NULL;
+         }
+     }
+     if (started > 0) {
+         char msg[128];
+         snprintf(msg, sizeof(msg), "[GA] %d asynchronous islands done, %llu migrants taken in, %llu dropped",
+                  started, received, dropped);
+         ga_log(ctx, GA_LOG_INFO, msg);
+     }
+ 
+     /* Migrants still in transit are owned by their mailbox. */
+     for (int i = 0; boxes && i < islands; i++) {
+         if (!boxes[i]) continue;
+         Chromosome *m;
+         while ((m = (Chromosome*)ga_mailbox_pop(boxes[i])) != NULL) {
+             ctx->free_chromosome(m);
+         }
+         ga_mailbox_destroy(boxes[i]);
+     }
+     free(tasks);
+     free(boxes);
+     free(tids);
+     return (ok && started == islands) ? 0 : -1;
+ }
+ 
  /**
   * @brief Main Genetic Algorithm thread function.
   *
@@ -389,14 +1338,29 @@
          return NULL;
      }
  
+     if (p->population_size < 1) {
+         return NULL;
+     }
+ 
+     /* Island model and evaluation workers (0 selects the defaults); no range may be empty. */
+     int islands   = p->island_count > 0 ? p->island_count : ISLAND_COUNT;
+     int mig_every = p->migration_interval > 0 ? p->migration_interval : MIGRATION_INTERVAL;
+     int migrants  = p->migrants_per_island > 0 ? p->migrants_per_island : MIGRANTS_PER_ISL;
+     int elites    = p->elite_count > 0 ? p->elite_count : 1; /* Per island; the best always survives. */
+     int N         = p->worker_count > 0 ? p->worker_count : islands;
+     if (islands > p->population_size) islands = p->population_size;
+     if (N > p->population_size) N = p->population_size;
+     int async     = p->async_islands != 0; /* Island threads replace the evaluation workers. */
+     if (async) N = 0;
+ 
      /* Build a barrier that includes N worker threads + the GA master thread => total N+1. */
      pthread_barrier_t bar;
-     int N = ISLAND_COUNT;
      pthread_barrier_init(&bar, NULL, N + 1);
  
      /* Prepare tasks + threads. */
-     FitTask tasks[N];    /* Array of FitTask structs, one per thread. */
-     pthread_t tids[N];   /* Array of thread IDs. */
+     FitTask *tasks = (FitTask*)calloc((size_t)N, sizeof(FitTask));     /* One FitTask per worker. */
+     pthread_t *tids = (pthread_t*)calloc((size_t)N, sizeof(pthread_t)); /* Worker thread IDs. */
+     IslandRange *isl = (IslandRange*)malloc((size_t)islands * sizeof(IslandRange));
  
      /**
       * represent the population as an array of Chromosome
@@ -404,33 +1368,97 @@
       */
      Chromosome **pop     = (Chromosome**)malloc(p->population_size * sizeof(Chromosome*));
      Chromosome **new_pop = (Chromosome**)malloc(p->population_size * sizeof(Chromosome*));
-     if (!pop || !new_pop) {
+ 
+     /**
+      * Fitness of every slot, indexed in parallel with pop / new_pop (each island is a
+      * contiguous slice): workers store scores there and selection, migration and best
+      * tracking scan these arrays instead of dereferencing chromosomes.
+      */
+     double *fit     = (double*)alloc_cache_aligned((size_t)p->population_size * sizeof(double));
+     double *new_fit = (double*)alloc_cache_aligned((size_t)p->population_size * sizeof(double));
+     /* Migration scratch. */
+     FitRank *order  = (FitRank*)malloc((size_t)p->population_size * sizeof(FitRank));
+ 
+     /**
+      * Lockstep mode takes every chromosome from one pool holding two generations: the
+      * parents and the children bred from them (elites survive in place, so at most
+      * population_size - islands children exist at a time). Async islands own their pools.
+      */
+     GAChromosomePool *pool = NULL;
+     if (!async) {
+         pool = ga_chromosome_pool_create(2 * (size_t)p->population_size, (size_t)p->nb_shapes);
+     }
+     if (!pop || !new_pop || !fit || !new_fit || !order || !isl || (N > 0 && (!tasks || !tids))
+         || (!async && !pool)) {
          fprintf(stderr, "[GA] Out of memory for population arrays.\n");
          pthread_barrier_destroy(&bar);
+         free(tasks);
+         free(tids);
+         free(isl);
          if (pop) free(pop);
          if (new_pop) free(new_pop);
+         free(fit);
+         free(new_fit);
+         free(order);
+         ga_chromosome_pool_destroy(pool);
          return NULL;
      }
  
-     /* Divide population among islands. */
-     int isl_size = p->population_size / ISLAND_COUNT; /* Size of each island's slice. */
-     IslandRange isl[ISLAND_COUNT];                    /* Array of island ranges. */
-     for (int i = 0; i < ISLAND_COUNT; i++) {
-         isl[i].start = i * isl_size;
-         if (i == ISLAND_COUNT - 1) {
-             isl[i].end = p->population_size - 1;
-         } else {
-             isl[i].end = (i + 1) * isl_size - 1;
+     /* Divide population among islands, as evenly as possible. */
+     for (int i = 0; i < islands; i++) {
+         isl[i] = split_range(p->population_size, islands, i);
+     }
+ 
+     /* Genome hash -> fitness cache shared by all workers (optional). */
+     GAFitnessCache *fcache = NULL;
+     if (ctx->fitness_cache_slots) {
+         fcache = ga_fitness_cache_create(ctx->fitness_cache_slots);
+         if (!fcache) {
+             fprintf(stderr, "[GA] Out of memory for the fitness cache, running without it.\n");
          }
      }
  
-     /* Create worker threads. Each worker receives a FitTask. */
-     for (int k = 0; k < N; k++) {
-         tasks[k].first = isl[k].start;
-         tasks[k].last  = isl[k].end + 1; /* 'end' is exclusive in the worker loop. */
-         tasks[k].ctx   = ctx;
-         tasks[k].bar   = &bar;
+     /* Prepare one FitTask per worker, each with its own scratch; the population is
+      * shared out dynamically, independent of the island boundaries. */
+     size_t chunk_cap = N > 0 ? (size_t)max_chunk(p->population_size, N) : 0; /* Largest claimable chunk. */
+     int ready = 0; /* Tasks initialized. */
+     while (ready < N && init_fit_task(&tasks[ready], ctx, &bar, ready, N, chunk_cap, fcache) == 0) {
+         ready++;
+     }
+ 
+     /* The GA thread's own context, used to re-score bests with exact_fitness_func. */
+     GAEvalContext master_eval = { N, N, NULL, 0 };
+     if (ctx->exact_fitness_func) {
+         master_eval.scratch      = alloc_cache_aligned(ctx->eval_scratch_size);
+         master_eval.scratch_size = master_eval.scratch ? ctx->eval_scratch_size : 0;
+     }
  
+     /* Without a scratch area every evaluation fails: stop rather than evolve on garbage. */
+     if (ready < N || (ctx->exact_fitness_func && ctx->eval_scratch_size && !master_eval.scratch)) {
+         fprintf(stderr, "[GA] Out of memory for evaluation scratch areas, stopping the run.\n");
+         for (int k = 0; k < ready; k++) {
+             release_fit_task(&tasks[k]);
+         }
+         free(master_eval.scratch);
+         ga_fitness_cache_destroy(fcache);
+         pthread_barrier_destroy(&bar);
+         free(tasks);
+         free(tids);
+         free(isl);
+         free(pop);
+         free(new_pop);
+         free(fit);
+         free(new_fit);
+         free(order);
+         ga_chromosome_pool_destroy(pool);
+         if (ctx->running) {
+             *ctx->running = 0;
+         }
+         return NULL;
+     }
+ 
+     /* Create worker threads. */
+     for (int k = 0; k < N; k++) {
          int ret = pthread_create(&tids[k], NULL, fit_worker, &tasks[k]);
          if (ret != 0) {
              fprintf(stderr, "[GA] pthread_create failed for worker %d.\n", k);
@@ -446,40 +1474,26 @@
      }
  
      /* -------------------- 2) Initialize population -------------------- */
-     for (int i = 0; i < p->population_size; i++) {
-         Chromosome *chr = ctx->alloc_chromosome(p->nb_shapes);
-         if (!chr) {
-             fprintf(stderr, "[GA] Out of memory creating chromosome.\n");
-             for (int j = 0; j < i; j++) {
-                 ctx->free_chromosome(pop[j]);
-             }
-             free(pop);
-             free(new_pop);
-             pthread_barrier_destroy(&bar);
-             return NULL;
-         }
-         random_init_chrom(chr);
-         pop[i] = chr;
-     }
+     /* Chromosomes are randomized (and evaluated) in parallel, by the workers or the islands. */
+     memset(pop, 0, p->population_size * sizeof(Chromosome*));
  
-     /* Evaluate fitness of the initial population in parallel. */
-     g_eval_pop = pop;
-     pthread_barrier_wait(&bar); /* start */
-     pthread_barrier_wait(&bar); /* done */
- 
-     Chromosome *best = pop[0]; /* Pointer to the best Chromosome found so far. */
-     for (int i = 1; i < p->population_size; i++) {
-         if (pop[i]->fitness < best->fitness) {
-             best = pop[i];
+     Chromosome *best = NULL; /* Pointer to the best Chromosome found so far. */
+     if (async) {
+         /* Islands evolve on their own threads; the lockstep loop below is skipped. */
+         run_async_islands(ctx, pop, new_pop, fit, new_fit, isl, islands, mig_every, migrants, elites,
+                           fcache);
+     } else {
+         /* Take the initial population from the pool, then fill and evaluate it in parallel. */
+         for (int i = 0; i < p->population_size; i++) {
+             pop[i] = ga_chromosome_pool_acquire(pool);
          }
-     }
+         run_phase(GA_PHASE_INIT, NULL, NULL, NULL, 0, pop, fit, p->population_size, &bar);
  
-     /* Update global best_snapshot if available. */
-     if (ctx->best_snapshot && ctx->best_mutex) {
-         pthread_mutex_lock(ctx->best_mutex);
-         copy_chromosome(ctx->best_snapshot, best);
-         ctx->best_snapshot->fitness = best->fitness;
-         pthread_mutex_unlock(ctx->best_mutex);
+         best = pop[ga_fitness_argmin(fit, 0, p->population_size - 1)];
+ 
+         /* Update global best_snapshot if available. */
+         publish_best(ctx, best, &master_eval);
+         notify_generation(ctx, fcache, 0, pop, fit, p->population_size, &best, &bar, &master_eval);
      }
  
      /* Measure time between iteration blocks. */
@@ -488,86 +1502,42 @@
      long long prev_msec = (long long)start_ts.tv_sec * 1000 + (start_ts.tv_nsec / 1000000LL);
  
      /* -------------------- 3) Main GA loop -------------------- */
-     for (int iter = 1; (ctx->running && (*ctx->running != 0)) && (iter <= p->max_iterations); iter++) {
- 
-         /* Perform ring-migration every MIGRATION_INTERVAL generations. */
-         if ((iter % MIGRATION_INTERVAL) == 0 && iter > 0) {
-             migrate(isl, pop);
-         }
- 
-         /* Reproduction per island. */
-         for (int isl_id = 0; isl_id < ISLAND_COUNT; isl_id++) {
-             Chromosome *best_isl = find_best(pop, isl[isl_id].start, isl[isl_id].end);
-             new_pop[isl[isl_id].start] = best_isl; /* Keep the island's best (elite) in new_pop. */
- 
-             /* Fill the rest of the island's slice. */
-             for (int i = isl[isl_id].start + 1; i <= isl[isl_id].end; i++) {
-                 Chromosome *pa = tournament_in_range(pop, isl[isl_id].start, isl[isl_id].end);
-                 Chromosome *pb = tournament_in_range(pop, isl[isl_id].start, isl[isl_id].end);
- 
-                 /* Ensure pa is not worse than pb for consistent crossover. */
-                 if (pb->fitness < pa->fitness) {
-                     Chromosome *tmp = pa;
-                     pa = pb;
-                     pb = tmp;
-                 }
- 
-                 Chromosome *child = ctx->alloc_chromosome(p->nb_shapes);
-                 if (!child) {
-                     fprintf(stderr, "[GA] Out of memory creating child.\n");
-                     break;
-                 }
- 
-                 float r01 = (float)rand() / (float)RAND_MAX; /* Random [0..1] for crossover test. */
-                 if (r01 < p->crossover_rate) {
-                     crossover(pa, pb, child);
-                 } else {
-                     /* No crossover => copy parent pa. */
-                     memcpy(child->shapes, pa->shapes, pa->n_shapes * sizeof(Gene));
-                 }
- 
-                 /* Mutation step. */
-                 for (size_t g = 0; g < child->n_shapes; g++) {
-                     float mr = (float)rand() / (float)RAND_MAX; /* Random [0..1] for mutation test. */
-                     if (mr < p->mutation_rate) {
-                         mutate_gene(&child->shapes[g]);
-                     }
-                 }
-                 new_pop[i] = child;
-             }
+     for (int iter = 1;
+          best && (ctx->running && (*ctx->running != 0)) && (iter <= p->max_iterations);
+          iter++) {
+ 
+         /* Perform ring-migration every mig_every generations. */
+         if (islands > 1 && (iter % mig_every) == 0 && iter > 0) {
+             migrate(isl, islands, migrants, pop, fit, order);
          }
  
-         /* Evaluate new_pop in parallel. */
-         g_eval_pop = new_pop;
-         pthread_barrier_wait(&bar); /* start */
-         pthread_barrier_wait(&bar); /* done */
+         /* Reproduction per island, in parallel with evaluation: once every island's elites
+          * are in front and every child slot holds a pooled chromosome, the workers breed
+          * and score their chunks of new_pop. */
+         for (int isl_id = 0; isl_id < islands; isl_id++) {
+             assign_children(pool, pop, fit, new_pop, isl[isl_id].start, isl[isl_id].end, elites);
+         }
+         run_phase(GA_PHASE_BREED, pop, fit, isl, islands, new_pop, new_fit, p->population_size, &bar);
  
          /* Find the best in new_pop, update global best if improved. */
-         for (int i = 0; i < p->population_size; i++) {
-             if (new_pop[i]->fitness < best->fitness) {
-                 best = new_pop[i];
-                 /* Lock best_snapshot and copy new best if available. */
-                 if (ctx->best_snapshot && ctx->best_mutex) {
-                     pthread_mutex_lock(ctx->best_mutex);
-                     copy_chromosome(ctx->best_snapshot, best);
-                     ctx->best_snapshot->fitness = best->fitness;
-                     pthread_mutex_unlock(ctx->best_mutex);
-                 }
-             }
+         int gen_best = ga_fitness_argmin(new_fit, 0, p->population_size - 1);
+         if (new_fit[gen_best] < best->fitness) {
+             best = new_pop[gen_best];
+             /* Lock best_snapshot and copy new best if available. */
+             publish_best(ctx, best, &master_eval);
          }
  
-         /* Free old generation, except for the elites they are directly reused in new_pop. */
-         for (int isl_id = 0; isl_id < ISLAND_COUNT; isl_id++) {
-             Chromosome *kept = new_pop[isl[isl_id].start];
-             for (int i = isl[isl_id].start; i <= isl[isl_id].end; i++) {
-                 if (pop[i] != kept) {
-                     ctx->free_chromosome(pop[i]);
-                 }
-             }
+         /* Recycle the old generation, except for the elites they are directly reused in new_pop. */
+         for (int isl_id = 0; isl_id < islands; isl_id++) {
+             free_old_island(pool, pop, new_pop, isl[isl_id].start, isl[isl_id].end);
          }
  
          /* Move new_pop => pop. */
          memcpy(pop, new_pop, p->population_size * sizeof(Chromosome*));
+         memcpy(fit, new_fit, p->population_size * sizeof(double));
+
+         /* Let the fitness side react to the finished generation (e.g. refine its resolution). */
+         notify_generation(ctx, fcache, iter, pop, fit, p->population_size, &best, &bar, &master_eval);
  
          /* Optionally measure performance every 100 iterations. */
          if ((iter % 100) == 0) {
@@ -576,8 +1546,33 @@
              long long now_msec = (long long)now_ts.tv_sec * 1000 + (now_ts.tv_nsec / 1000000LL);
              long long elapsed_100 = now_msec - prev_msec;
              prev_msec = now_msec;
-             fprintf(stdout, "[GA %d] best fitness = %.4f, last 100 iters: %lld ms\n",
-                     iter, best->fitness, elapsed_100);
+             /* Counters are only touched by workers between the barriers. */
+             unsigned long long skipped = 0, lookups = 0, hits = 0, chunks = 0;
+             for (int k = 0; k < N; k++) {
+                 skipped += tasks[k].skipped;
+                 lookups += tasks[k].cache_lookups;
+                 hits    += tasks[k].cache_hits;
+                 chunks  += tasks[k].chunks;
+                 tasks[k].skipped = tasks[k].cache_lookups = tasks[k].cache_hits = 0;
+                 tasks[k].chunks  = 0;
+             }
+             fprintf(stdout, "[GA %d] best fitness = %.4f, last 100 iters: %lld ms, "
+                             "clean skipped: %llu, fitness cache: %.1f%% of %llu\n",
+                     iter, best->fitness, elapsed_100, skipped,
+                     lookups ? 100.0 * (double)hits / (double)lookups : 0.0, lookups);
+ 
+             /* Idle time of each worker: evaluation wall time it did not spend on chunks. */
+             fprintf(stdout, "[GA %d] %llu chunks, evaluation %.0f ms, worker idle:",
+                     iter, chunks, (double)g_eval_wall_ns / 1.0e6);
+             for (int k = 0; k < N; k++) {
+                 unsigned long long busy = tasks[k].busy_ns;
+                 unsigned long long idle = g_eval_wall_ns > busy ? g_eval_wall_ns - busy : 0;
+                 double pct = g_eval_wall_ns ? 100.0 * (double)idle / (double)g_eval_wall_ns : 0.0;
+                 fprintf(stdout, " %.0f%%", pct);
+                 tasks[k].busy_ns = 0;
+             }
+             fputc('\n', stdout);
+             g_eval_wall_ns = 0;
          }
      }
  
@@ -585,21 +1580,29 @@
      if (ctx->running) {
          *ctx->running = 0;
      }
+     g_phase = GA_PHASE_STOP;
      pthread_barrier_wait(&bar); /* start */
      pthread_barrier_wait(&bar); /* done */
  
-     /* Join worker threads. */
+     /* Join worker threads and release their scratch areas. */
      for (int k = 0; k < N; k++) {
          pthread_join(tids[k], NULL);
+         release_fit_task(&tasks[k]);
      }
+     free(master_eval.scratch);
+     ga_fitness_cache_destroy(fcache);
      pthread_barrier_destroy(&bar);
+     free(tasks);
+     free(tids);
+     free(isl);
  
-     /* Free population memory. */
-     for (int i = 0; i < p->population_size; i++) {
-         ctx->free_chromosome(pop[i]);
-     }
+     /* Free population memory (every lockstep chromosome lives in the pool). */
+     ga_chromosome_pool_destroy(pool);
      free(pop);
      free(new_pop);
+     free(fit);
+     free(new_fit);
+     free(order);
  
      return NULL;
  }
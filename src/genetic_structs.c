@@ -50,6 +50,11 @@
      c->n_shapes = n_shapes;
      // Initialize the fitness to INFINITY, indicating an uncomputed state
      c->fitness  = INFINITY;
+     // No parent: the first evaluation must be a full one
+     c->parent   = NULL;
+     c->parent_fitness = INFINITY;
+     // Not evaluated yet
+     c->dirty    = 1;
      // Return the allocated and initialized chromosome
      return c;
  }
@@ -105,3 +110,117 @@
      // Perform a deep copy of the gene data from the source to the destination chromosome
      memcpy(dst->shapes, src->shapes, src->n_shapes * sizeof(Gene));
  }
+ 
+ /**
+  * @brief Mixes one 32-bit value into a running hash (multiply-xorshift round).
+  */
+ static inline uint64_t hash_mix(uint64_t h, uint32_t v)
+ {
+     h = (h ^ v) * 0x9E3779B97F4A7C15ull;
+     return h ^ (h >> 29);
+ }
+ 
+ /**
+  * @brief Fold a gene into a running 64-bit hash.
+  *
+  * The shape type, the geometry fields of that type and the packed RGBA color are
+  * mixed in turn. Unused union bytes are never read, so the hash does not depend on
+  * how the gene was initialized.
+  *
+  * @param h Hash of the preceding genes (or a seed).
+  * @param g Gene to fold in.
+  * @return The updated hash.
+  *
+  * Example:
+  * @code
+  * uint64_t h = seed;
+  * for (size_t i = 0; i < c->n_shapes; i++) h = gene_hash(h, &c->shapes[i]);
+  * @endcode
+  */
+ uint64_t gene_hash(uint64_t h, const Gene *g)
+ {
+     ShapeType type = gene_type(g);
+     h = hash_mix(h, (uint32_t)type);
+     if (type == SHAPE_CIRCLE) {
+         h = hash_mix(h, (uint32_t)g->geom.circle.cx);
+         h = hash_mix(h, (uint32_t)g->geom.circle.cy);
+         h = hash_mix(h, (uint32_t)g->geom.circle.radius);
+     } else {
+         h = hash_mix(h, (uint32_t)g->geom.triangle.x1);
+         h = hash_mix(h, (uint32_t)g->geom.triangle.y1);
+         h = hash_mix(h, (uint32_t)g->geom.triangle.x2);
+         h = hash_mix(h, (uint32_t)g->geom.triangle.y2);
+         h = hash_mix(h, (uint32_t)g->geom.triangle.x3);
+         h = hash_mix(h, (uint32_t)g->geom.triangle.y3);
+     }
+     return hash_mix(h, ((uint32_t)g->r << 24) | ((uint32_t)g->g << 16)
+                      | ((uint32_t)g->b << 8) | (uint32_t)g->a);
+ }
+ 
+ /**
+  * @brief Hash of a whole genome (gene count and every gene, in order).
+  *
+  * @param c Chromosome to hash.
+  * @return 64-bit hash (0 for a NULL chromosome).
+  */
+ uint64_t chromosome_hash(const Chromosome *c)
+ {
+     if (!c) return 0;
+     uint64_t h = hash_mix(0xC2B2AE3D27D4EB4Full, (uint32_t)c->n_shapes);
+     for (size_t i = 0; i < c->n_shapes; i++) {
+         h = gene_hash(h, &c->shapes[i]);
+     }
+     return h;
+ }
+ 
+ /**
+  * @brief Mixes one 64-bit word into a running hash (murmur3 finalizer round).
+  *
+  * Other constants and word width than hash_mix(), so that the two hashes are independent.
+  */
+ static inline uint64_t check_mix(uint64_t h, uint64_t v)
+ {
+     h ^= v;
+     h ^= h >> 33;
+     h *= 0xFF51AFD7ED558CCDull;
+     h ^= h >> 33;
+     h *= 0xC4CEB9FE1A85EC53ull;
+     return h ^ (h >> 33);
+ }
+ 
+ /**
+  * @brief Second genome hash, independent of chromosome_hash().
+  *
+  * Reads the same fields as gene_hash() (never the unused union bytes), packed into
+  * 64-bit words.
+  *
+  * @param c Chromosome to hash.
+  * @return 64-bit hash (0 for a NULL chromosome).
+  */
+ uint64_t chromosome_check_hash(const Chromosome *c)
+ {
+     if (!c) return 0;
+     uint64_t h = check_mix(0x5851F42D4C957F2Dull, (uint64_t)c->n_shapes);
+     for (size_t i = 0; i < c->n_shapes; i++) {
+         const Gene *g = &c->shapes[i];
+         ShapeType type = gene_type(g);
+         uint64_t geom, rest = ((uint64_t)g->r << 56) | ((uint64_t)g->g << 48)
+                             | ((uint64_t)g->b << 40) | ((uint64_t)g->a << 32);
+         if (type == SHAPE_CIRCLE) {
+             geom = (uint64_t)(uint16_t)g->geom.circle.cx
+                  | (uint64_t)(uint16_t)g->geom.circle.cy << 16
+                  | (uint64_t)(uint16_t)g->geom.circle.radius << 32;
+         } else {
+             geom = (uint64_t)(uint16_t)g->geom.triangle.x1
+                  | (uint64_t)(uint16_t)g->geom.triangle.y1 << 16
+                  | (uint64_t)(uint16_t)g->geom.triangle.x2 << 32
+                  | (uint64_t)(uint16_t)g->geom.triangle.y2 << 48;
+             rest |= (uint64_t)(uint16_t)g->geom.triangle.x3
+                   | (uint64_t)(uint16_t)g->geom.triangle.y3 << 16;
+         }
+         h = check_mix(h, (uint64_t)type);
+         h = check_mix(h, geom);
+         h = check_mix(h, rest);
+     }
+     return h;
+ }
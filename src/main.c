@@ -34,11 +34,13 @@
  #include <SDL2/SDL.h>
  #include <signal.h>
  #include <pthread.h>
+ #include <errno.h>
  #include <stdio.h>
  #include <stdlib.h>
  #include <time.h>
  #include <stdatomic.h>
  #include <stdint.h>
+ #include <limits.h>
  #include <unistd.h>
  
  #if defined(__APPLE__)
@@ -51,6 +53,7 @@
  #include "../includes/software_rendering/main_runtime.h"
  #include "../includes/genetic_algorithm/genetic_art.h"
  #include "../includes/tools/system_tools.h"
+ #include "../includes/software_rendering/ga_kernels.h"
  
  /* GUI log buffer sizes */
  #define LOG_MAX_LINES  1024  /**< Maximum number of log lines */
@@ -147,8 +150,11 @@
   * @brief Performs advanced system checks on CPU features, OpenGL, OpenCL, and thread count.
   *
   * This function performs various system checks and logs the results. It initializes a mutex to protect access to the system capabilities structure.
+  * It also selects the renderer kernel variants (scalar/SSE4.1/AVX2/AVX-512BW) for the detected CPU and logs them.
+  *
+  * @return Number of hardware threads detected (at least 1), used to size the fitness workers.
   */
- static void do_startup_selftest(void)
+ static int do_startup_selftest(void)
  {
      // Define a static variable to hold the system capabilities
      static SysCapabilities caps;
@@ -165,8 +171,40 @@
                              nk_rgb(180, 255, 180),  /**< Green color for info messages */
                              nk_rgb(255, 255, 0));   /**< Yellow color for warning messages */
  
+     // Pick the renderer kernels matching this CPU and report the choice
+     ga_kernels_select(&caps);
+     {
+         char buffer[128];
+         const GAKernels *k = ga_kernels();
+         snprintf(buffer, sizeof(buffer), "Kernels: blend=%s, mse=%s",
+                  k->blend_span_name, k->sse_span_name);
+         logStr(buffer, nk_rgb(180, 255, 180));
+     }
+ 
      // Destroy the mutex
      pthread_mutex_destroy(&caps.mutex);
+ 
+     return caps.maxThreads > INT_MAX ? INT_MAX : (int)caps.maxThreads;
+ }
+ 
+ /**
+  * @brief Parses a GA seed given as a decimal or 0x-prefixed unsigned integer.
+  *
+  * @param text Seed text (may be NULL).
+  * @param[out] seed Parsed seed, on success.
+  * @return 1 if @p text holds a whole unsigned 64-bit number, 0 otherwise.
+  */
+ static int parse_seed(const char *text, uint64_t *seed)
+ {
+     if (!text || !*text || *text == '-')
+         return 0;
+     char *end = NULL;
+     errno = 0;
+     unsigned long long v = strtoull(text, &end, 0);
+     if (errno != 0 || *end != '\0')
+         return 0;
+     *seed = (uint64_t)v;
+     return 1;
  }
  
  /**
@@ -175,7 +213,8 @@
   * This function is the main entry point of the application. It initializes SDL and Nuklear, loads the reference image, creates the GA context, and runs the main loop.
   *
   * @param argc Argument count.
-  * @param argv Argument vector. Expects a single image path as argument.
+  * @param argv Argument vector. Expects an image path, optionally followed by a GA seed
+  *             (the GA_SEED environment variable is used when it is absent).
   * @return EXIT_SUCCESS on successful execution, EXIT_FAILURE otherwise.
   */
  int main(int argc, char *argv[])
@@ -186,12 +225,18 @@
      // Check if the correct number of arguments was provided
      if (argc < 2) {
          // Print the usage message and exit with failure
-         fprintf(stderr, "Usage: %s <image.bmp>\n", argv[0]);
+         fprintf(stderr, "Usage: %s <image.bmp> [seed]\n", argv[0]);
          return EXIT_FAILURE;
      }
  
-     // Seed the random number generator
-     srand((unsigned)time(NULL));
+     // Seed of the GA's random streams: from the command line, else from GA_SEED, else the
+     // clock. It is logged, so that passing it back replays the run.
+     uint64_t ga_seed = (uint64_t)time(NULL);
+     const char *seed_text = argc > 2 ? argv[2] : getenv("GA_SEED");
+     if (seed_text && !parse_seed(seed_text, &ga_seed)) {
+         fprintf(stderr, "Invalid seed '%s' (expected an unsigned 64-bit integer).\n", seed_text);
+         return EXIT_FAILURE;
+     }
  
      // Initialize SDL and create the main window and renderer
      SDL_Window *window = NULL;  /**< Pointer to main SDL window */
@@ -212,7 +257,8 @@
      // Load the reference BMP file from the command line argument
      SDL_PixelFormat *fmt = NULL;  /**< Pointer to the SDL pixel format */
      Uint32 *ref_pixels = NULL;  /**< Pointer to the reference image pixels */
-     SDL_Texture *tex_ref = load_reference_image(argv[1], renderer, &fmt, &ref_pixels);
+     GAImagePyramid pyramid = {0};  /**< Mip chain of the reference image (pyramid mode) */
+     SDL_Texture *tex_ref = load_reference_image(argv[1], renderer, &fmt, &ref_pixels, &pyramid);
      if (!tex_ref || !fmt || !ref_pixels) {
          // Clean up and exit with failure if the reference image could not be loaded
          cleanup_all();
@@ -236,12 +282,18 @@
          return EXIT_FAILURE;
      }
      // Run system checks and log them
-     do_startup_selftest();
+     int hw_threads = do_startup_selftest();
      // Log welcome messages
      logStr("Welcome to GA Art (a X-platform C boilerplate for genetic coding exploration)", nk_rgb(127, 255, 0));
      logStr("by LoganSeven, under MIT license (for now)", nk_rgb(127, 255, 0));
+     {
+         char buffer[64];
+         snprintf(buffer, sizeof(buffer), "GA seed: %llu", (unsigned long long)ga_seed);
+         logStr(buffer, nk_rgb(180, 255, 180));
+     }
      // Build the GA context
-     GAContext ctx = build_ga_context(ref_pixels, best_pixels, fmt, IMAGE_W * sizeof(Uint32), &g_running);
+     GAContext ctx = build_ga_context(ref_pixels, best_pixels, fmt, IMAGE_W * sizeof(Uint32), &g_running, &pyramid,
+                                      hw_threads, ga_seed);
      ctx.log_func = ga_log_to_gui;  /**< Set the log function for the GA context */
  
      // Create the GA thread
@@ -278,7 +330,8 @@
      pthread_join(ga_tid, NULL);
      // Clean up the GA context resources
      destroy_ga_context(&ctx);
-     // Free the reference and best image pixels
+     // Free the reference pyramid, then the reference and best image pixels
+     ga_pyramid_free(&pyramid);
      free(ref_pixels);
      free(best_pixels);
      // Free the SDL pixel format
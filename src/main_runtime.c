@@ -152,12 +152,14 @@
   * @param renderer Valid SDL_Renderer.
   * @param fmt Output pointer to SDL_PixelFormat (caller must free with SDL_FreeFormat()).
   * @param ref_pixels Output pointer to newly allocated ARGB buffer for reference image.
+  * @param pyramid Optional output mip chain of the reference pixels (may be NULL).
   * @return SDL_Texture* reference image texture or NULL on error.
   */
  SDL_Texture *load_reference_image(const char *filename,
                                      SDL_Renderer *renderer,
                                      SDL_PixelFormat **fmt,
-                                     Uint32 **ref_pixels)
+                                     Uint32 **ref_pixels,
+                                     GAImagePyramid *pyramid)
  {
      // Validate input parameters.
      if (!filename || !renderer || !fmt || !ref_pixels) {
@@ -247,6 +249,12 @@
      }
      SDL_UnlockSurface(final);
  
+     // Build the mip chain used by the coarse-to-fine mode (a failure only disables it).
+     if (pyramid && ga_pyramid_build(pyramid, *ref_pixels, IMAGE_W, IMAGE_H, PYRAMID_LEVELS) != 0) {
+         fprintf(stderr, "Warning: could not build the reference image pyramid.\n");
+         memset(pyramid, 0, sizeof(*pyramid));
+     }
+ 
      // Create texture from final surface.
      SDL_Texture *tex = SDL_CreateTextureFromSurface(renderer, final);
      SDL_FreeSurface(final);
@@ -269,26 +277,50 @@
   * @param fmt SDL pixel format for the textures.
   * @param pitch The pitch (row size in bytes) for the ARGB buffers.
   * @param running Shared atomic flag for stopping.
+  * @param pyramid Optional mip chain of the reference (enables pyramid mode if it has several levels).
+  * @param worker_count Number of fitness evaluation threads (typically the detected hardware threads).
+  * @param seed Run seed of the GA's random streams.
   * @return A fully configured GAContext structure.
   */
  GAContext build_ga_context(Uint32 *ref_pixels,
                              Uint32 *best_pixels,
                              SDL_PixelFormat *fmt,
                              int pitch,
-                             atomic_int *running)
+                             atomic_int *running,
+                             const GAImagePyramid *pyramid,
+                             int worker_count,
+                             uint64_t seed)
  {
-    // Allocate and initialize GA parameters.
+    // Allocate and initialize GA parameters (4 islands exchanging 1 migrant every 5 generations).
      GAParams *params = (GAParams *)malloc(sizeof(GAParams));
-     *params = (GAParams){ 500, 100, 2, 0.05f, 0.70f, 1000000 };
+     *params = (GAParams){ 500, 100, 2, 0.05f, 0.70f, 1000000, 4, 5, 1, worker_count, ASYNC_ISLANDS, seed };
  
      // Allocate and initialize fitness parameters.
      GAFitnessParams *fp = (GAFitnessParams *)malloc(sizeof(GAFitnessParams));
      fp->ref_pixels     = ref_pixels;
-     fp->scratch_pixels = (Uint32 *)calloc(IMAGE_W * IMAGE_H, sizeof(Uint32));
      fp->fmt            = fmt;
      fp->pitch          = pitch;
      fp->width          = IMAGE_W;
      fp->height         = IMAGE_H;
+     fp->incremental    = 1;
+ 
+     // Progressive refinement: start at the coarsest level scoring 1 row in 4, then double
+     // the density / move one level finer after 50 generations below 0.1% gain.
+     // Asynchronous islands never pause together, so they score at full resolution only.
+     int use_pyramid       = pyramid && pyramid->count > 1 && !params->async_islands;
+     fp->pyramid           = use_pyramid ? pyramid : NULL;
+     fp->level             = use_pyramid ? pyramid->count - 1 : 0;
+     fp->sample_shift_max  = params->async_islands ? 0 : 2;
+     fp->sample_shift      = fp->sample_shift_max;
+     fp->stall_generations = 50;
+     fp->stall_tolerance   = 0.001;
+     fp->stall_best        = 1.0e30;
+     fp->stall_count       = 0;
+ 
+     // Least-squares colors for the genes a mutation changed, solved against summed-area
+     // tables of every reference level (the step is skipped if they cannot be built).
+     fp->color_tables          = ga_color_tables_create(fp);
+     fp->color_solve_max_genes = COLOR_SOLVE_MAX_GENES;
  
      // Initialize GAContext structure.
      GAContext ctx;
@@ -299,7 +331,13 @@
      ctx.best_mutex       = (pthread_mutex_t *)malloc(sizeof(pthread_mutex_t));
      ctx.best_snapshot    = chromosome_create(params->nb_shapes);
      ctx.fitness_func     = ga_sdl_fitness_callback;
+     ctx.batch_fitness_func = ga_sdl_batch_fitness_callback; /* Whole worker slice per call. */
+     ctx.optimize_func    = fp->color_tables ? ga_sdl_solve_colors_callback : NULL;
      ctx.fitness_data     = fp;
+     ctx.eval_scratch_size = ga_fitness_scratch_size(fp); /* One private canvas per worker. */
+     ctx.fitness_cache_slots = FITNESS_CACHE_SLOTS; /* Scores are pure per level / row sampling. */
+     ctx.exact_fitness_func = ga_sdl_exact_fitness_callback;
+     ctx.generation_func  = params->async_islands ? NULL : ga_refine_generation_callback;
      ctx.log_func         = NULL;
      ctx.log_user_data    = NULL;
  
@@ -464,7 +502,7 @@
  /**
   * @brief Frees all resources in the GAContext and its dependencies.
   *
-  * This function frees fitness parameters and scratch pixels, frees the best chromosome snapshot,
+  * This function frees fitness parameters, frees the best chromosome snapshot,
   * destroys and frees the best chromosome mutex, and frees GA parameters.
   *
   * @param ctx Pointer to GAContext to destroy.
@@ -473,10 +511,10 @@
  {
      if (!ctx) return;
  
-     // Free fitness parameters and scratch pixels.
+     // Free fitness parameters and their color tables (worker canvases are owned by the GA engine).
      GAFitnessParams *fp = (GAFitnessParams *)ctx->fitness_data;
      if (fp) {
-         free(fp->scratch_pixels);
+         ga_color_tables_destroy(fp->color_tables);
          free(fp);
      }
      // Free the best chromosome snapshot.
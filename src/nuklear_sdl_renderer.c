@@ -413,7 +413,7 @@ NK_API void nk_sdl_draw_chromosome(struct nk_command_buffer *canvas,
         struct nk_color col = nk_rgba(g->r, g->g, g->b, g->a);
 
         // Check if the shape type is a circle
-        if (g->type == SHAPE_CIRCLE) {
+        if (gene_type(g) == SHAPE_CIRCLE) {
             // Calculate the circle's center coordinates with offsets
             float x = off_x + (float)g->geom.circle.cx;
             float y = off_y + (float)g->geom.circle.cy;
@@ -59,6 +59,7 @@ static void detect_cpu_features(SysCapabilities *caps)
     caps->avx    = __builtin_cpu_supports("avx");
     caps->avx2   = __builtin_cpu_supports("avx2");
     caps->avx512 = __builtin_cpu_supports("avx512f");
+    caps->avx512bw = __builtin_cpu_supports("avx512bw");
 #else
     /* Fallback: mark them false if we cannot detect. */
     caps->sse    = false;
@@ -69,6 +70,7 @@ static void detect_cpu_features(SysCapabilities *caps)
     caps->avx    = false;
     caps->avx2   = false;
     caps->avx512 = false;
+    caps->avx512bw = false;
 #endif
 }
 
@@ -127,17 +129,18 @@ void log_system_capabilities(const SysCapabilities *caps,
     pthread_mutex_lock((pthread_mutex_t *)&caps->mutex);
 
     /* CPU feature lines */
-    log_feature_line("SSE   ", caps->sse,    logFunction, infoColor, warnColor);
-    log_feature_line("SSE2  ", caps->sse2,   logFunction, infoColor, warnColor);
-    log_feature_line("SSE3  ", caps->sse3,   logFunction, infoColor, warnColor);
-    log_feature_line("SSE4  ", caps->sse4,   logFunction, infoColor, warnColor);
-    log_feature_line("AVX   ", caps->avx,    logFunction, infoColor, warnColor);
-    log_feature_line("AVX2  ", caps->avx2,   logFunction, infoColor, warnColor);
-    log_feature_line("AVX512", caps->avx512, logFunction, infoColor, warnColor);
+    log_feature_line("SSE     ", caps->sse,      logFunction, infoColor, warnColor);
+    log_feature_line("SSE2    ", caps->sse2,     logFunction, infoColor, warnColor);
+    log_feature_line("SSE3    ", caps->sse3,     logFunction, infoColor, warnColor);
+    log_feature_line("SSE4    ", caps->sse4,     logFunction, infoColor, warnColor);
+    log_feature_line("AVX     ", caps->avx,      logFunction, infoColor, warnColor);
+    log_feature_line("AVX2    ", caps->avx2,     logFunction, infoColor, warnColor);
+    log_feature_line("AVX512  ", caps->avx512,   logFunction, infoColor, warnColor);
+    log_feature_line("AVX512BW", caps->avx512bw, logFunction, infoColor, warnColor);
 
     /* GPU/Rendering lines */
-    log_feature_line("OpenGL", caps->hasOpenGL, logFunction, infoColor, warnColor);
-    log_feature_line("OpenCL", caps->hasOpenCL, logFunction, infoColor, warnColor);
+    log_feature_line("OpenGL  ", caps->hasOpenGL, logFunction, infoColor, warnColor);
+    log_feature_line("OpenCL  ", caps->hasOpenCL, logFunction, infoColor, warnColor);
 
     /* CPU thread count line */
     {